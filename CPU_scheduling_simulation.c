@@ -1,59 +1,429 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define MAX_BURSTS 16 // maximum number of CPU bursts per process
+#define MAX_DEVICES 4 // maximum number of simulated I/O devices
+#define WORKLOAD_CACHE_SIZE 256 // slots of the daemon's parsed-workload cache
+#define MAX_WORKLOAD_SIZE 8192 // largest workload text the daemon accepts, in bytes
+#define DEFAULT_WORKERS 4 // daemon threads serving requests
+#define REQUEST_TIMEOUT 2000 // ms a daemon client gets to send its whole request, and the most a reply write may block
+#define WHEEL_SLOTS 64 // slots per level of the aging timing wheel
+#define WHEEL_SPAN (WHEEL_SLOTS * WHEEL_SLOTS) // ticks covered by the two levels
+#define RT_HORIZON_LIMIT 100000 // periodic releases stop here even if the hyperperiod is longer
+#define LATENESS_BUCKETS 18 // on time, then lateness 1, 2~3, 4~7, ...
+#define PRIORITY_SCALE 1000000 // fixed-point priorities and alpha are stored in millionths
+#define MAX_PRIORITY 1000000000 // largest priority magnitude, far from overflowing int64_t in millionths
+#define EVENT_LOG_MAGIC "SCHDLOG1" // header of an event log file, followed by the Event records
+#define GROUP_STRIDE 720720 // virtual runtime of one tick at weight 1, other weights carry the remainder of the division
+#define MAX_GROUP_WEIGHT 1000 // largest weight of a process group
+
+// per-tick trace line, skipped entirely when there is no trace stream
+#define TRACE(stream, ...) do { if ((stream) != NULL) fprintf((stream), __VA_ARGS__); } while (0)
+
+// replay log record, skipped when no log is being recorded
+#define LOG_EVENT(time, pid, type) do { if (event_log != NULL) log_event((time), (pid), (type)); } while (0)
+#define LOG_FINISH(time, pid, response) do { LOG_EVENT((time), (pid), EV_FINISH); LOG_EVENT((response), (pid), EV_RESPONSE); } while (0)
+
+// Scheduling loops are written once and instantiated per variant: ENGINE_INLINE forces them into each call of
+// RUN_VARIANT, where the trace stream(a stream or literal NULL) and the overhead model are compile-time constants.
+// That folds away the TRACE lines of the loop bodies and of finish_tick(), and the overhead_model guards. Helpers
+// called out of line(context_switch, wake_io_processes, admit_arrivals, spend_switch_overhead) still test the stream
+// at run time, and increase_waiting_time(), highest_waiting_process() and shown_priority() still branch on the
+// use_aging_wheel and fixed_priority flags; only the priority loop's own comparisons get fixed_point as a constant.
+// Per-run time against the generic loops(gcc -O2, 10 processes, ~10k ticks and ~40k for EDF/RM, quantum 2, alpha 0.5,
+// PRIO on the aging wheel) :
+//   quiet, no overhead : FCFS -30%, RR -30%, PRIO -4%, EDF/RM -90%(the task scan also became event-driven)
+//   quiet, overhead    : FCFS -10%, RR -10%, PRIO -4%, EDF/RM -87%
+//   traced             : within noise, the time goes to fprintf
+#define ENGINE_INLINE static inline __attribute__((always_inline))
+#define RUN_VARIANT(loop, output, report, ...) \
+    do \
+    { \
+        bool overhead_model = force_overhead_model || switch_cost > 0 || cache_penalty > 0; \
+        if ((output) == NULL && !overhead_model) \
+            loop(__VA_ARGS__, NULL, report, false); \
+        else if ((output) == NULL) \
+            loop(__VA_ARGS__, NULL, report, true); \
+        else if (!overhead_model) \
+            loop(__VA_ARGS__, output, report, false); \
+        else \
+            loop(__VA_ARGS__, output, report, true); \
+    } while (0)
 
 typedef struct process {
     struct process* next; // linked list 
     int pid; // unique numeric process ID(1 to 10)
     float base_priority; // integer value 
     float priority; // real priority
+    int64_t base_priority_fixed; // base_priority in 1/PRIORITY_SCALE units, parsed from the input text
+    int64_t priority_fixed; // priority in 1/PRIORITY_SCALE units, used instead of priority with fixed_priority
     int arrival_time; // time when the task arrives in the unit of ms
-    int burst_time; // cpu time requested by a task, in the unit of ms
-    int remaining_time;
+    int burst_time; // cpu time requested by a task, in the unit of ms (sum of all CPU bursts)
+    int remaining_time; // time left in the current CPU burst
     int waiting_time; // sum of time spent waiting in the ready queue
     int response_time; // time from request to first response 
     int turnaround_time; // time for each process to complete
     int time_in_waiting; // for priority scheduling(time in ready queue)
+    int num_bursts; // number of CPU bursts(1 for a pure CPU-bound task)
+    int current_burst; // index of the CPU burst in progress
+    int cpu_burst[MAX_BURSTS]; // CPU burst lengths
+    int io_burst[MAX_BURSTS]; // I/O burst that follows cpu_burst[i]
+    int io_device[MAX_BURSTS]; // device that serves io_burst[i]
+    int io_remaining; // time left in the current I/O burst
+    int io_time; // sum of time spent blocked(device queue + service)
+    int blocked_at; // time when the process entered the device queue
+    int ready_time; // time when the process came back from I/O, -1 otherwise
+    int run_mark; // value of cpu_handoffs when the process last ran, -1 if it never ran
+    int aging_since; // first tick of the current aging streak, -1 when not aging(time_in_waiting is up to date)
+    int crossover_time; // tick when the aged priority first exceeds the running process
+    int wheel_slot; // slot of the aging timing wheel holding the process, -1 if none
+    struct process* wheel_next; // list of the wheel slot
+    struct process* wheel_prev;
+    int period; // release interval of a periodic task, 0 for a one-shot job
+    int relative_deadline; // deadline counted from each release, 0 for none
+    int jobs_released; // jobs of the task released so far
+    int jobs_done; // jobs of the task completed so far(the current job is jobs_done)
+    int job_start; // time the current job first ran, -1 before that
+    int deadline_misses;
+    int max_lateness;
+    int group; // process group id from the input, -1 for none(group 0 in a group run)
+    int group_weight; // weight given with the group id, 0 for the default of 1
+    int group_slot; // index of the group in groups[] during a group run
 }Process;
 
-Process* job_front = NULL;
-Process* job_rear = NULL;
-Process* ready_front = NULL;
-Process* ready_rear = NULL;
+typedef struct device {
+    Process* front; // FIFO of processes blocked on this device
+    Process* rear;
+    int busy_time; // time spent servicing I/O bursts
+}Device;
+
+typedef struct group { // process group of the fair-share policy
+    int id; // group id from the input
+    int weight; // cpu share relative to the other groups
+    int64_t vruntime; // cpu time received, GROUP_STRIDE / weight per tick
+    int vruntime_remainder; // GROUP_STRIDE % weight carried over, the exact virtual runtime is vruntime + vruntime_remainder / weight
+    Process* front; // ready members, in the order of the policy inside the group
+    Process* rear;
+    int heap_index; // position in group_heap, -1 while no member is ready
+    int members;
+    int cpu_time;
+    float waiting_time; // sums over the finished members
+    float response_time;
+    float turnaround_time;
+}Group;
+
+typedef struct event { // one record of the replay log, 8 bytes in host byte order
+    int32_t time; // tick of the event, the response time for EV_RESPONSE
+    int16_t pid; // process, the policy(FCFS 0, RR 1, PRIO 2, EDF 3, RM 4, group fair share 5 + group_policy) for EV_SECTION
+    int16_t type;
+}Event;
+
+typedef struct event_log {
+    Event* events;
+    size_t count;
+    size_t capacity;
+}EventLog;
+
+enum group_policy { GROUP_FCFS, GROUP_RR, GROUP_PRIO }; // order of the ready members inside a group
+
+enum event_type { EV_SECTION, EV_ARRIVAL, EV_RUN, EV_IDLE, EV_SWITCH, EV_CACHE_REFILL, EV_BLOCK, EV_WAKE, EV_FINISH, EV_RESPONSE, EV_MISS, EV_TYPES };
+
+typedef struct engine { // configuration of the scheduling engine, compared against the reference by the fuzzer
+    const char* name;
+    bool aging_wheel; // timing wheel instead of the per-tick aging and scan
+    bool traced; // traced instead of quiet loop variant
+    bool overhead_model; // overhead variant even when no cost is set
+}Engine;
+
+typedef struct workload_entry {
+    uint64_t hash; // FNV-1a hash of the workload text
+    char* text; // workload text, to tell hash collisions apart
+    size_t length;
+    Process processes[10]; // parsed and sorted by arrival time
+}WorkloadEntry;
+
+// Scheduler state is per thread, so daemon workers can simulate concurrently
+_Thread_local Process* job_front = NULL;
+_Thread_local Process* job_rear = NULL;
+_Thread_local Process* ready_front = NULL;
+_Thread_local Process* ready_rear = NULL;
+_Thread_local Device devices[MAX_DEVICES]; // blocked queue: one FIFO per device
+_Thread_local int num_devices = 0;
+_Thread_local int io_busy_time = 0; // time at least one device was busy
+_Thread_local int overlap_time = 0; // time the cpu and at least one device were both busy
+_Thread_local float aging_alpha = 0; // alpha of the priority run in progress
+_Thread_local bool fixed_priority = false; // priorities and alpha as scaled integers: exact, same on every compiler
+_Thread_local int64_t aging_alpha_fixed = 0; // aging_alpha in 1/PRIORITY_SCALE units
+_Thread_local int switch_cost = 0; // time the cpu spends on each context switch
+_Thread_local int cache_penalty = 0; // extra time to refill the cache of a process whose working set was displaced
+_Thread_local int cache_size = 1; // number of other processes that must run in between to displace a working set
+_Thread_local bool switch_pending = false; // a context switch happened during the current tick
+_Thread_local int switch_stall = 0; // context-switch time left before the running process continues
+_Thread_local int cache_stall = 0; // cache-refill time left before the running process continues
+_Thread_local int switch_overhead = 0; // total time spent on context switches
+_Thread_local int cache_overhead = 0; // total time spent on cache refills
+_Thread_local int cpu_handoffs = 0; // number of times the cpu changed hands
+_Thread_local Process* last_runner = NULL; // process that ran most recently
+_Thread_local int aging_wheel_mode = -1; // 1 : timing wheel, 0 : per-tick aging and scan, -1 : wheel only at alpha 0
+_Thread_local bool use_aging_wheel = false; // aging_wheel_mode resolved for the priority run in progress
+_Thread_local Process* aging_wheel[2 * WHEEL_SLOTS]; // level 0 : one tick per slot, level 1 : WHEEL_SLOTS ticks per slot
+_Thread_local int ready_insertions = 0; // bumped on every insertion into the ready queue
+_Thread_local int aged_insertions = 0; // ready_insertions at the last aging bookkeeping
+_Thread_local Process* aged_front = NULL; // ready_front at the last aging bookkeeping
+_Thread_local bool preemption_check = false; // a waiting process may now outrank the running one
+_Thread_local bool rt_edf = true; // real-time run in progress orders jobs by deadline(EDF) or by period(RM)
+_Thread_local Process* rt_heap[10]; // min-heap of the tasks with a released, unfinished job
+_Thread_local int rt_heap_size = 0;
+_Thread_local int rt_horizon = 0; // no periodic release at or after this time
+_Thread_local int lateness_buckets[LATENESS_BUCKETS];
+_Thread_local bool force_overhead_model = false; // run the overhead variants even when no cost is set
+_Thread_local EventLog* event_log = NULL; // events of the run in progress are appended here, NULL for none
+_Thread_local Group groups[10]; // groups of the run in progress, at most one per process
+_Thread_local int num_groups = 0;
+_Thread_local Group* group_heap[10]; // min-heap of the groups with a ready member, by virtual runtime
+_Thread_local int group_heap_size = 0;
+_Thread_local int64_t group_clock = 0; // virtual runtime of the last group picked, a waking group starts no earlier
+_Thread_local int group_policy = GROUP_FCFS;
+
+const char* event_names[EV_TYPES] = { "section", "arrival", "run", "idle", "context switch", "cache refill",
+    "blocked", "I/O done", "finished", "response time", "deadline miss" };
+const char* section_names[8] = { "FCFS", "RR", "PRIO", "EDF", "RM", "GROUP-FCFS", "GROUP-RR", "GROUP-PRIO" };
+
+// The first engine is the reference: per-tick aging and scan, traced, generic overhead path. Add new engines here.
+const Engine fuzz_engines[] = {
+    { "reference", false, true, true },
+    { "aging wheel", true, true, true },
+    { "quiet", true, false, true },
+    { "quiet, no overhead model", true, false, false },
+};
+
+const double liu_layland_bound[10] = { 1.000000, 0.828427, 0.779763, 0.756828, 0.743492, 0.734772, 0.728627, 0.724062, 0.720538, 0.717735 }; // n(2^(1/n) - 1)
+
+// Daemon state, shared by the worker threads
+WorkloadEntry workload_cache[WORKLOAD_CACHE_SIZE];
+pthread_rwlock_t workload_cache_lock = PTHREAD_RWLOCK_INITIALIZER;
+int client_queue[64]; // accepted connections waiting for a worker
+int client_head = 0;
+int client_count = 0;
+pthread_mutex_t client_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t client_ready = PTHREAD_COND_INITIALIZER;
+pthread_cond_t client_space = PTHREAD_COND_INITIALIZER;
 
 void init_process(Process processes[], int num_processes);
 void read_process(Process processes[], char* input_filename);
-void simulate(Process processes[], int quantum, float alpha, char* output_file);
+bool parse_process(Process processes[], FILE* file, FILE* errors);
+void sort_process(Process processes[]);
+void load_job_queue(Process processes[]);
+void simulate(Process processes[], int quantum, float alpha, int64_t alpha_fixed, char* output_file);
+void simulate_fcfs(Process processes[], FILE* output, FILE* report);
+void simulate_rr(Process processes[], int quantum, FILE* output, FILE* report);
+void simulate_priority(Process processes[], float alpha, int64_t alpha_fixed, FILE* output, FILE* report);
+void simulate_edf(Process processes[], FILE* output, FILE* report);
+void simulate_rm(Process processes[], FILE* output, FILE* report);
+ENGINE_INLINE void fcfs_loop(Process processes[], FILE* output, FILE* report, const bool overhead_model);
+ENGINE_INLINE void rr_loop(Process processes[], int quantum, FILE* output, FILE* report, const bool overhead_model);
+ENGINE_INLINE void priority_loop(Process processes[], float alpha, int64_t alpha_fixed, const bool fixed_point, FILE* output, FILE* report, const bool overhead_model);
+ENGINE_INLINE bool outranks(Process* a, Process* b, const bool fixed_point);
+double shown_priority(Process* process);
+bool parse_fixed(const char* text, int64_t* value);
+ENGINE_INLINE void realtime_loop(Process processes[], bool edf, FILE* output, FILE* report, const bool overhead_model);
+bool has_deadlines(Process processes[]);
+int realtime_horizon(Process processes[]);
+int job_release(Process* process, int job);
+int job_deadline(Process* process);
+int next_release(Process* process);
+int next_deadline(Process* process, int current_time);
+bool rt_before(Process* a, Process* b);
+void rt_heap_push(Process* process);
+void rt_heap_pop();
+void record_lateness(Process* process, int lateness);
+void print_lateness_summary(FILE* output);
+void print_utilization_bound(FILE* output, Process processes[], bool edf);
+bool rm_response_times_fit(Process processes[]);
+void simulate_group(Process processes[], int policy, int quantum, FILE* output, FILE* report);
+ENGINE_INLINE void group_loop(Process processes[], int policy, int quantum, FILE* output, FILE* report, const bool overhead_model);
+bool has_groups(Process processes[]);
+void load_groups(Process processes[]);
+void group_enqueue(Process* process);
+void group_dequeue(Process* process);
+bool group_before(Group* a, Group* b);
+void group_heap_place(Group* group, int index);
+void group_heap_up(Group* group);
+void group_heap_down(Group* group);
+void group_heap_remove(Group* group);
+void print_group_summary(FILE* output);
 void insert_process_job(Process* process);
 void insert_process_ready(Process* process);
 void remove_from_job(Process* process);
 void remove_from_ready(Process* process);
 void increase_waiting_time();
+void reset_aging_wheel();
+void age_ready_queue(int current_time);
+int aged_time_in_waiting(Process* process, int current_time);
+float aged_priority(Process* process, int time_in_waiting);
+int64_t aged_priority_fixed(Process* process, int time_in_waiting);
+void schedule_crossover(Process* process, Process* running, int current_time);
+void wheel_insert(Process* process, int current_time);
+void wheel_remove(Process* process);
+void advance_aging_wheel(int current_time);
+Process* highest_waiting_process(int current_time);
+void reset_devices(Process processes[]);
+bool has_io_burst(Process* process);
+void block_process(Process* process, int current_time);
+void wake_io_processes(FILE* output, int current_time);
+void advance_devices(bool cpu_busy);
+void print_io_summary(FILE* output, int total_time);
+void reset_overhead();
+void context_switch(FILE* output);
+bool in_switch_overhead();
+void spend_switch_overhead(FILE* output, int current_time);
+void admit_arrivals(FILE* output, int current_time);
+ENGINE_INLINE void finish_tick(Process* runner, int current_time, const bool overhead_model);
+void print_overhead_summary(FILE* output, int total_time, int idle_time);
+int run_daemon(char* socket_path, int num_workers);
+void* daemon_worker(void* arg);
+void serve_client(int client);
+long receive_request(int client, char* buffer, size_t size);
+uint64_t hash_workload(const char* text, size_t length);
+bool lookup_workload(const char* text, size_t length, Process processes[], FILE* errors);
+void log_event(int time, int pid, int type);
+void append_event(EventLog* log, Event event);
+bool write_event_log(EventLog* log, char* filename);
+bool read_event_log(EventLog* log, char* filename);
+long first_divergence(EventLog* a, EventLog* b);
+void print_event(FILE* output, const char* label, EventLog* log, long index);
+void print_divergence(FILE* output, const char* label_a, EventLog* a, const char* label_b, EventLog* b, long index);
+int diff_event_logs(char* filename_a, char* filename_b);
+size_t random_workload(char* text, size_t size, unsigned* seed, bool* well_formed);
+void run_engine(Process processes[], const Engine* engine, int quantum, float alpha, int64_t alpha_fixed, EventLog* log, FILE* sink);
+int run_fuzz(int iterations, unsigned seed);
 
 
 char* input_filename;
 char* output_filename;
 int quantum;
 float alpha;
+int64_t alpha_fixed; // the same alpha in millionths, parsed from its text
 
 int main(int argc, char* argv[])
 {
-    if (argc != 5) // for the case that user does not provide the correct number of arguments
+    if (argc >= 2 && strcmp(argv[1], "--daemon") == 0) // long-running simulation service
     {
-        printf("Usage: %s [input_filename] [output_filename] [timequantum_for_RR] [alpha_for_PRIO]\n", argv[0]);
+        if (argc < 3 || argc > 4)
+        {
+            printf("Usage: %s --daemon [socket_path] [worker_threads]\n", argv[0]);
+            return 1;
+        }
+        return run_daemon(argv[2], argc == 4 ? atoi(argv[3]) : DEFAULT_WORKERS);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "--diff") == 0) // compare two replay logs
+    {
+        if (argc != 4)
+        {
+            printf("Usage: %s --diff [event_log_a] [event_log_b]\n", argv[0]);
+            return 2;
+        }
+        return diff_event_logs(argv[2], argv[3]);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "--fuzz") == 0) // random workloads through every engine
+    {
+        char* end = "";
+        long iterations = argc >= 3 ? strtol(argv[2], &end, 10) : 1000;
+        bool valid = argc <= 4 && *end == '\0' && iterations > 0 && iterations <= INT_MAX;
+        unsigned long seed = argc == 4 ? strtoul(argv[3], &end, 10) : 1;
+        if (!valid || *end != '\0' || (argc == 4 && (argv[3][0] == '-' || seed > UINT_MAX))) // positive iterations, non-negative seed
+        {
+            printf("Usage: %s --fuzz [iterations] [seed]\n", argv[0]);
+            return 1;
+        }
+        return run_fuzz((int)iterations, (unsigned)seed);
+    }
+
+    if (argc < 5 || (argc - 5) % 2 != 0) // for the case that user does not provide the correct number of arguments
+    {
+        printf("Usage: %s [input_filename] [output_filename] [timequantum_for_RR] [alpha_for_PRIO] [-s switch_cost] [-c cache_penalty] [-k cache_size] [-w aging_wheel(0|1)] [-l event_log] [-f fixed_point(0|1)]\n", argv[0]);
         return 1; // Say that program occurs an error
     }
 
     input_filename = argv[1];
     output_filename = argv[2];
     quantum = atoi(argv[3]);
-    alpha = atof(argv[4]);
+    alpha = strtof(argv[4], NULL);
+    if (!parse_fixed(argv[4], &alpha_fixed)) // not a plain decimal with up to 6 decimals
+    {
+        alpha_fixed = -1; // rejected by simulate() as out of range
+    }
+    char* log_filename = NULL;
+
+    for (int i = 5; i < argc; i += 2) // optional overhead model
+    {
+        if (strcmp(argv[i], "-s") == 0)
+        {
+            switch_cost = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "-c") == 0)
+        {
+            cache_penalty = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "-k") == 0)
+        {
+            cache_size = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "-w") == 0) // 0 : reference per-tick aging and scan, default : wheel only at alpha 0
+        {
+            aging_wheel_mode = atoi(argv[i + 1]) != 0;
+        }
+        else if (strcmp(argv[i], "-f") == 0) // 1 : scaled integer priorities
+        {
+            fixed_priority = atoi(argv[i + 1]) != 0;
+        }
+        else if (strcmp(argv[i], "-l") == 0) // binary replay log of the run
+        {
+            log_filename = argv[i + 1];
+        }
+        else
+        {
+            printf("Usage: %s [input_filename] [output_filename] [timequantum_for_RR] [alpha_for_PRIO] [-s switch_cost] [-c cache_penalty] [-k cache_size] [-w aging_wheel(0|1)] [-l event_log] [-f fixed_point(0|1)]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (switch_cost < 0 || cache_penalty < 0 || cache_size < 1) // defensive coding
+    {
+        perror("Error; switch cost and cache penalty are non-negative, cache size is positive");
+        exit(1);
+    }
 
     Process processes[10];
     init_process(processes, 10);
     read_process(processes, input_filename);
+    sort_process(processes);
 
-    simulate(processes, quantum, alpha, output_filename);
+    EventLog log = { NULL, 0, 0 };
+    if (log_filename != NULL)
+    {
+        event_log = &log;
+    }
+    simulate(processes, quantum, alpha, alpha_fixed, output_filename);
+    if (log_filename != NULL && !write_event_log(&log, log_filename))
+    {
+        perror("Error Writing Event Log");
+        exit(1);
+    }
+    free(log.events);
     return 0;
 }
 
@@ -67,6 +437,8 @@ void init_process(Process processes[], int num_processes)
         p.pid = i + 1;
         p.priority = 0;
         p.base_priority = 0;
+        p.priority_fixed = 0;
+        p.base_priority_fixed = 0;
         p.arrival_time = 0;
         p.burst_time = 0;
         p.remaining_time = 0;
@@ -75,6 +447,28 @@ void init_process(Process processes[], int num_processes)
         p.turnaround_time = 0;
         p.next = NULL;
         p.time_in_waiting = 0;
+        p.num_bursts = 1;
+        p.current_burst = 0;
+        p.io_remaining = 0;
+        p.io_time = 0;
+        p.blocked_at = 0;
+        p.ready_time = -1;
+        p.run_mark = -1;
+        p.aging_since = -1;
+        p.crossover_time = 0;
+        p.wheel_slot = -1;
+        p.wheel_next = NULL;
+        p.wheel_prev = NULL;
+        p.period = 0;
+        p.relative_deadline = 0;
+        p.jobs_released = 0;
+        p.jobs_done = 0;
+        p.job_start = -1;
+        p.deadline_misses = 0;
+        p.max_lateness = 0;
+        p.group = -1;
+        p.group_weight = 0;
+        p.group_slot = 0;
         processes[i] = p;
     }
 }
@@ -89,21 +483,126 @@ void read_process(Process processes[], char* input_filename)
         exit(1);
     }
 
-    for (int i = 0; i < 10; i++)
+    if (!parse_process(processes, file, stderr))
     {
-        fscanf(file, "%d %f %d %d", &processes[i].pid, &processes[i].base_priority,
-            &processes[i].arrival_time, &processes[i].burst_time);
-        processes[i].remaining_time = processes[i].burst_time;
+        exit(1);
     }
     fclose(file);
 }
 
 
-void simulate(Process processes[], int quantum, float alpha, char* output_file)
+bool parse_process(Process processes[], FILE* file, FILE* errors) // false on a malformed workload, the reason goes to errors(NULL for none)
 {
-    int current_time = 0;
-    int completed_processes = 0;
+    // exactly 10 lines, one process per line : pid priority arrival_time cpu_burst [device io_burst cpu_burst]... [@ period [deadline]] [# group [weight]]
+    char line[512];
+    for (int i = 0; i < 10; i++)
+    {
+        if (fgets(line, sizeof(line), file) == NULL) // the loops wait for all 10 processes, a short workload never ends
+        {
+            TRACE(errors, "Error; workload has %d processes instead of 10\n", i);
+            return false;
+        }
+        int offset = 0;
+        int n = 0;
+        char priority[32] = "0";
+        if (sscanf(line, "%d %31s %d %d%n", &processes[i].pid, priority,
+            &processes[i].arrival_time, &processes[i].cpu_burst[0], &offset) != 4 ||
+            processes[i].arrival_time < 0 || processes[i].cpu_burst[0] < 1) // defensive coding
+        {
+            TRACE(errors, "Error; line %d is not a process with an arrival time and a positive CPU burst\n", i + 1);
+            return false;
+        }
+        if (!parse_fixed(priority, &processes[i].base_priority_fixed)) // defensive coding
+        {
+            TRACE(errors, "Error; process %d has an invalid priority\n", processes[i].pid);
+            return false;
+        }
+        processes[i].base_priority = strtof(priority, NULL); // same text, so both paths see the same number
+        processes[i].io_burst[0] = 0;
+        processes[i].io_device[0] = 0;
+
+        int device, io_burst, cpu_burst;
+        while (sscanf(line + offset, "%d %d %d%n", &device, &io_burst, &cpu_burst, &n) == 3)
+        {
+            if (processes[i].num_bursts == MAX_BURSTS || device < 0 || device >= MAX_DEVICES || io_burst < 1 || cpu_burst < 1) // defensive coding
+            {
+                TRACE(errors, "Error; process %d has an invalid I/O burst\n", processes[i].pid);
+                return false;
+            }
+            processes[i].io_device[processes[i].num_bursts - 1] = device;
+            processes[i].io_burst[processes[i].num_bursts - 1] = io_burst;
+            processes[i].cpu_burst[processes[i].num_bursts] = cpu_burst;
+            processes[i].io_burst[processes[i].num_bursts] = 0;
+            processes[i].io_device[processes[i].num_bursts] = 0;
+            processes[i].num_bursts++;
+            offset += n;
+        }
+
+        int period, deadline;
+        if (sscanf(line + offset, " @ %d%n", &period, &n) == 1) // real-time task, period 0 for a one-shot job
+        {
+            offset += n;
+            if (sscanf(line + offset, "%d%n", &deadline, &n) == 1)
+            {
+                offset += n;
+            }
+            else
+            {
+                deadline = period; // implicit deadline
+            }
+            if (period < 0 || deadline < 1) // defensive coding
+            {
+                TRACE(errors, "Error; process %d has an invalid period or deadline\n", processes[i].pid);
+                return false;
+            }
+            processes[i].period = period;
+            processes[i].relative_deadline = deadline;
+        }
+
+        int group, weight;
+        if (sscanf(line + offset, " # %d%n", &group, &n) == 1) // member of a process group, weight 1 unless given
+        {
+            offset += n;
+            bool weighted = sscanf(line + offset, "%d", &weight) == 1;
+            if (group < 0 || (weighted && (weight < 1 || weight > MAX_GROUP_WEIGHT))) // defensive coding
+            {
+                TRACE(errors, "Error; process %d has an invalid group or weight\n", processes[i].pid);
+                return false;
+            }
+            for (int j = 0; j < i && weighted; j++)
+            {
+                if (processes[j].group == group && processes[j].group_weight != 0 && processes[j].group_weight != weight)
+                {
+                    TRACE(errors, "Error; group %d has conflicting weights\n", group);
+                    return false;
+                }
+            }
+            processes[i].group = group;
+            processes[i].group_weight = weighted ? weight : 0;
+        }
+
+        processes[i].burst_time = 0;
+        for (int j = 0; j < processes[i].num_bursts; j++)
+        {
+            processes[i].burst_time += processes[i].cpu_burst[j];
+        }
+        processes[i].remaining_time = processes[i].cpu_burst[0];
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (strspn(line, " \t\r\n") != strlen(line)) // trailing blank lines are fine
+        {
+            TRACE(errors, "Error; workload has more than 10 processes\n");
+            return false;
+        }
+    }
+    return true;
+}
+
 
+void sort_process(Process processes[])
+{
     // Sort processes array by arrival time using bubble sort
     for (int i = 0; i < 10 - 1; i++)
     {
@@ -118,35 +617,112 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
             }
         }
     }
+}
+
+
+void load_job_queue(Process processes[]) // Start a scheduling run from a sorted workload
+{
+    job_front = NULL;
+    job_rear = NULL;
+    ready_front = NULL;
+    ready_rear = NULL;
 
     // Insert sorted processes into job queue
     for (int i = 0; i < 10; i++)
     {
         insert_process_job(&processes[i]);
     }
+    reset_devices(processes);
+    reset_overhead();
+}
 
 
+void simulate(Process processes[], int quantum, float alpha, int64_t alpha_fixed, char* output_file)
+{
+    Process run[10]; // every policy starts from the same parsed and sorted workload
+
     FILE* output = fopen(output_file, "w"); // open output file
     if (output == NULL) // defensive coding
     {
         perror("Error Opening Output File");
         exit(1);
     }
+
+    memcpy(run, processes, sizeof(run));
+    simulate_fcfs(run, output, output);
+
+    if (quantum < 1) // defensive coding
+    {
+        perror("Error; Quantum is positive integer");
+        exit(1);
+    }
+    memcpy(run, processes, sizeof(run));
+    simulate_rr(run, quantum, output, output);
+
+    if (alpha_fixed < 0 || alpha_fixed > PRIORITY_SCALE) // defensive coding
+    {
+        perror("Error; alpha range[0~1]");
+        exit(1);
+    }
+    memcpy(run, processes, sizeof(run));
+    simulate_priority(run, alpha, alpha_fixed, output, output);
+
+    if (has_deadlines(processes)) // real-time sections only for workloads with periods or deadlines
+    {
+        memcpy(run, processes, sizeof(run));
+        simulate_edf(run, output, output);
+        memcpy(run, processes, sizeof(run));
+        simulate_rm(run, output, output);
+    }
+
+    if (has_groups(processes)) // fair-share sections only for workloads with group ids
+    {
+        for (int policy = GROUP_FCFS; policy <= GROUP_PRIO; policy++)
+        {
+            memcpy(run, processes, sizeof(run));
+            simulate_group(run, policy, quantum, output, output);
+        }
+    }
+
+    fclose(output);
+}
+
+void simulate_fcfs(Process processes[], FILE* output, FILE* report) // trace goes to output(NULL for none), summary to report
+{
+    RUN_VARIANT(fcfs_loop, output, report, processes);
+}
+
+ENGINE_INLINE void fcfs_loop(Process processes[], FILE* output, FILE* report, const bool overhead_model)
+{
+    int current_time = 0;
+    int completed_processes = 0;
     float average_cpu_usage = 0;
     float average_waiting_time = 0;
     float average_response_time = 0;
     float average_turnaround_time = 0;
     int idle_time = 0;
 
-    fprintf(output, "Scheduling : FCFS\n");
-    fprintf(output, "====================================================\n");
+    load_job_queue(processes);
+
+    fprintf(report, "Scheduling : FCFS\n");
+    LOG_EVENT(0, 0, EV_SECTION);
+    fprintf(report, "====================================================\n");
     while (completed_processes < 10) // FCFS loop
     {
+        int idle_mark = idle_time;
+        wake_io_processes(output, current_time);
+        if (overhead_model && in_switch_overhead()) // cpu is busy switching, the running process does not progress
+        {
+            spend_switch_overhead(output, current_time);
+            current_time++;
+            continue;
+        }
+
         Process* current_process = ready_front;
         Process* arrived_process = job_front;
-        if (current_process == NULL && ready_front == NULL && job_front->arrival_time != current_time)
+        if (current_process == NULL && ready_front == NULL && (job_front == NULL || job_front->arrival_time != current_time))
         {
-            fprintf(output, "<time %d> ---- system is idle ----\n", current_time);
+            TRACE(output, "<time %d> ---- system is idle ----\n", current_time);
             idle_time++;
         }
 
@@ -154,7 +730,8 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
 
         if (job_front != NULL && job_front->arrival_time == current_time)
         {
-            fprintf(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+            TRACE(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+            LOG_EVENT(current_time, arrived_process->pid, EV_ARRIVAL);
             remove_from_job(arrived_process);
             insert_process_ready(arrived_process);
             current_process = ready_front;
@@ -162,12 +739,13 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
 	        {
 		        arrived_process = job_front;
 	        }
-            if(arrived_process->arrival_time == current_time && arrived_process->next != NULL)
+            if(job_front != NULL && arrived_process->arrival_time == current_time)
             {
                 same_arrival = true;
                 while (same_arrival == true)
                 {
-                    fprintf(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+                    TRACE(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+                    LOG_EVENT(current_time, arrived_process->pid, EV_ARRIVAL);
                     remove_from_job(arrived_process);
                     insert_process_ready(arrived_process);
                     current_process = ready_front;
@@ -200,34 +778,53 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
 
             if (current_process != NULL && current_process->remaining_time == 0)
             {
-                // average_waiting_time += (current_time - current_process->arrival_time) - current_process->burst_time;
-                average_waiting_time += current_process->response_time;
-                average_response_time += current_process->response_time;
-                average_turnaround_time += (current_time) - current_process->arrival_time;
+                bool blocked = has_io_burst(current_process); // CPU burst is over, but the process still has I/O to do
 
-                completed_processes++;
-                fprintf(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
+                if (blocked)
+                {
+                    TRACE(output, "<time %d> process %d is blocked on device %d\n", current_time, current_process->pid, current_process->io_device[current_process->current_burst]);
+                }
+                else
+                {
+                    // average_waiting_time += (current_time - current_process->arrival_time) - current_process->burst_time;
+                    average_waiting_time += current_process->response_time + current_process->waiting_time;
+                    average_response_time += current_process->response_time;
+                    average_turnaround_time += (current_time) - current_process->arrival_time;
+                    LOG_FINISH(current_time, current_process->pid, current_process->response_time);
+
+                    completed_processes++;
+                    TRACE(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
+                }
 
                 if (completed_processes < 10 && ready_front->next != NULL)
                 {
-                    fprintf(output, "------------------------------ (Context-Switch)\n");
-		            fprintf(output, "<time %d> process %d is running\n",current_time,current_process->next->pid);
+                    context_switch(output);
+		            TRACE(output, "<time %d> process %d is running\n",current_time,current_process->next->pid);
                 }
                 else if (completed_processes < 10 && ready_front->next == NULL)
                 {
-                    fprintf(output, "<time %d> ---- system is idle ----\n", current_time);
+                    TRACE(output, "<time %d> ---- system is idle ----\n", current_time);
                     idle_time++;
                 }
                 else
                 {
-                    fprintf(output, "<time %d> all processes finish\n", current_time);
+                    TRACE(output, "<time %d> all processes finish\n", current_time);
                 }
 
                 remove_from_ready(current_process);
+                if (blocked)
+                {
+                    block_process(current_process, current_time);
+                }
 
                 if (ready_front != NULL)
                 {
                     current_process = ready_front;
+                    if (current_process->ready_time != -1) // back from I/O, it has been waiting since then
+                    {
+                        current_process->waiting_time += current_time - current_process->ready_time;
+                        current_process->ready_time = -1;
+                    }
                 }
                 else
                 {
@@ -236,7 +833,7 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
             }
             else
             {
-                fprintf(output, "<time %d> process %d is running\n", current_time, current_process->pid);
+                TRACE(output, "<time %d> process %d is running\n", current_time, current_process->pid);
             }
 
         }
@@ -244,70 +841,66 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
         {
             current_process->remaining_time--;
         }
+        finish_tick(idle_time == idle_mark ? ready_front : NULL, current_time, overhead_model); // the running process is always at the front of the ready queue
         current_time++;
     }
     average_cpu_usage = ((float)(current_time - 1 - idle_time)) /(current_time-1) * 100;
     average_waiting_time /= 10.0;
     average_response_time /= 10.0;
     average_turnaround_time /= 10.0;
-    fprintf(output, "====================================================\n");
-    fprintf(output, "Average cpu usage : %.2f %%\n", average_cpu_usage);
-    fprintf(output, "Average waiting time : %.2f \n", average_waiting_time);
-    fprintf(output, "Average response time : %.2f \n", average_response_time);
-    fprintf(output, "Average turnaround time : %.2f \n", average_turnaround_time);
-    fprintf(output, "*********************************************************************************\n");
-
-    fprintf(output, "Scheduling : RR\n");
-    fprintf(output, "====================================================\n");
-
-    init_process(processes, 10);
-    read_process(processes, input_filename);
+    fprintf(report, "====================================================\n");
+    fprintf(report, "Average cpu usage : %.2f %%\n", average_cpu_usage);
+    fprintf(report, "Average waiting time : %.2f \n", average_waiting_time);
+    fprintf(report, "Average response time : %.2f \n", average_response_time);
+    fprintf(report, "Average turnaround time : %.2f \n", average_turnaround_time);
+    print_io_summary(report, current_time - 1);
+    print_overhead_summary(report, current_time - 1, idle_time);
+    fprintf(report, "*********************************************************************************\n");
+}
 
-    // Sort processes array by arrival time using bubble sort
-    for (int i = 0; i < 10 - 1; i++)
-    {
-        for (int j = 0; j < 10 - i - 1; j++)
-        {
-            if (processes[j].arrival_time > processes[j + 1].arrival_time)
-            {
-                // Swap
-                Process temp = processes[j];
-                processes[j] = processes[j + 1];
-                processes[j + 1] = temp;
-            }
-        }
-    }
+void simulate_rr(Process processes[], int quantum, FILE* output, FILE* report)
+{
+    RUN_VARIANT(rr_loop, output, report, processes, quantum);
+}
 
-    // Initialize variables
+ENGINE_INLINE void rr_loop(Process processes[], int quantum, FILE* output, FILE* report, const bool overhead_model)
+{
+    int current_time = 0;
+    int completed_processes = 0;
+    float average_cpu_usage = 0;
+    float average_waiting_time = 0;
+    float average_response_time = 0;
+    float average_turnaround_time = 0;
+    int idle_time = 0;
     int quantum_cnt = 0;
-    completed_processes = 0;
-    current_time = 0;
-    idle_time = 0;
-    average_cpu_usage = 0;
-    average_waiting_time = 0;
-    average_response_time = 0;
-    average_turnaround_time = 0;
-
-    // Insert sorted processes into job queue
-    for (int i = 0; i < 10; i++)
-    {
-        insert_process_job(&processes[i]);
-    }
 
-    if (quantum < 1) // defensive coding
-    {
-        perror("Error; Quantum is positive integer");
-        exit(1);
-    }
+    load_job_queue(processes);
 
+    fprintf(report, "Scheduling : RR\n");
+    LOG_EVENT(0, 1, EV_SECTION);
+    fprintf(report, "====================================================\n");
     while (completed_processes < 10) // RR loop
     {
+        int idle_mark = idle_time;
+        bool was_idle = (ready_front == NULL);
+        wake_io_processes(output, current_time);
+        if (was_idle && ready_front != NULL) // back from I/O on an idle cpu, same as a new arrival
+        {
+            ready_front->remaining_time++;
+        }
+        if (overhead_model && in_switch_overhead()) // cpu is busy switching, the running process does not progress
+        {
+            spend_switch_overhead(output, current_time);
+            current_time++;
+            continue;
+        }
+
         Process* current_process = ready_front;
         Process* arrived_process = job_front;
 
         if (current_process == NULL && ready_front == NULL && (job_front == NULL || job_front->arrival_time != current_time))
         {
-            fprintf(output, "<time %d> ---- system is idle ----\n", current_time);
+            TRACE(output, "<time %d> ---- system is idle ----\n", current_time);
             idle_time++;
         }
 
@@ -315,7 +908,8 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
 
         if (job_front != NULL && job_front->arrival_time == current_time)
         {
-            fprintf(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+            TRACE(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+            LOG_EVENT(current_time, arrived_process->pid, EV_ARRIVAL);
             remove_from_job(arrived_process);
             insert_process_ready(arrived_process);
             current_process = ready_front;
@@ -327,12 +921,13 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
             {
                 arrived_process = job_front;
             }
-            if (arrived_process->arrival_time == current_time && arrived_process->next != NULL)
+            if (job_front != NULL && arrived_process->arrival_time == current_time)
             {
                 same_arrival = true;
                 while (same_arrival == true)
                 {
-                    fprintf(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+                    TRACE(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+                    LOG_EVENT(current_time, arrived_process->pid, EV_ARRIVAL);
                     remove_from_job(arrived_process);
                     insert_process_ready(arrived_process);
                     current_process = ready_front;
@@ -365,55 +960,89 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
 
             if(current_process->remaining_time == 1 && ready_front->next != NULL)
             {
-                average_waiting_time += (current_time)-current_process->arrival_time - current_process->burst_time;
-                average_response_time += current_process->response_time;
-                average_turnaround_time += (current_time)-current_process->arrival_time;
-                completed_processes++;
+                bool blocked = has_io_burst(current_process); // CPU burst is over, but the process still has I/O to do
+
+                if (blocked)
+                {
+                    TRACE(output, "<time %d> process %d is blocked on device %d\n", current_time, current_process->pid, current_process->io_device[current_process->current_burst]);
+                }
+                else
+                {
+                    average_waiting_time += (current_time)-current_process->arrival_time - current_process->burst_time - current_process->io_time;
+                    average_response_time += current_process->response_time;
+                    average_turnaround_time += (current_time)-current_process->arrival_time;
+                    LOG_FINISH(current_time, current_process->pid, current_process->response_time);
+                    completed_processes++;
+                }
 
                 if (completed_processes != 10)
                 {
-                    fprintf(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
+                    if (!blocked)
+                    {
+                        TRACE(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
+                    }
                     current_process = ready_front;
                     quantum_cnt = 0;
-                    fprintf(output, "------------------------------ (Context-Switch)\n");
-                    fprintf(output, "<time %d> process %d is running\n", current_time, current_process->next->pid);
+                    context_switch(output);
+                    TRACE(output, "<time %d> process %d is running\n", current_time, current_process->next->pid);
                 }
                 else
                 {
                     quantum_cnt = 0;
-                    fprintf(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
-                    fprintf(output, "<time %d> all processes finish\n", current_time);
+                    TRACE(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
+                    TRACE(output, "<time %d> all processes finish\n", current_time);
                 }
                 remove_from_ready(current_process);
+                if (blocked)
+                {
+                    block_process(current_process, current_time);
+                }
             }
 	        else if(current_process->remaining_time == 1 && ready_front->next ==  NULL)
 	        {
-		        average_waiting_time += (current_time)-current_process->arrival_time - current_process->burst_time;
-                average_response_time += current_process->response_time;
-                average_turnaround_time += (current_time)-current_process->arrival_time;
-                completed_processes++;
+                bool blocked = has_io_burst(current_process); // CPU burst is over, but the process still has I/O to do
+
+                if (blocked)
+                {
+                    TRACE(output, "<time %d> process %d is blocked on device %d\n", current_time, current_process->pid, current_process->io_device[current_process->current_burst]);
+                }
+                else
+                {
+                    average_waiting_time += (current_time)-current_process->arrival_time - current_process->burst_time - current_process->io_time;
+                    average_response_time += current_process->response_time;
+                    average_turnaround_time += (current_time)-current_process->arrival_time;
+                    LOG_FINISH(current_time, current_process->pid, current_process->response_time);
+                    completed_processes++;
+                }
 
                 if (completed_processes != 10)
                 {
-                    fprintf(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
+                    if (!blocked)
+                    {
+                        TRACE(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
+                    }
                     current_process = ready_front;
                     quantum_cnt = 0;
-                    fprintf(output, "<time %d> ---- system is idle ----\n", current_time);
+                    TRACE(output, "<time %d> ---- system is idle ----\n", current_time);
                     idle_time++;
                 }
                 else
                 {
                     quantum_cnt = 0;
-                    fprintf(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
-                    fprintf(output, "<time %d> all processes finish\n", current_time);
+                    TRACE(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
+                    TRACE(output, "<time %d> all processes finish\n", current_time);
                 }
                 remove_from_ready(current_process);
+                if (blocked)
+                {
+                    block_process(current_process, current_time);
+                }
             }
             else if (quantum_cnt >= quantum && current_process->remaining_time != 0)
             {
 		        if(ready_front->next == NULL)
 		        {
-			        fprintf(output, "<time %d> process %d is running\n", current_time, current_process->pid);
+			        TRACE(output, "<time %d> process %d is running\n", current_time, current_process->pid);
                     		current_process->remaining_time--;
 		        }
 		        else if(ready_front->next != NULL)
@@ -423,17 +1052,18 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
                     insert_process_ready(current_process);
                     current_process = ready_front;
                     quantum_cnt = 0;
-                    fprintf(output, "------------------------------ (Context-Switch)\n");
-                    fprintf(output, "<time %d> process %d is running\n", current_time, current_process->pid);
+                    context_switch(output);
+                    TRACE(output, "<time %d> process %d is running\n", current_time, current_process->pid);
                      // Reset quantum counter
 		        }
             }
             else
             {
                 current_process->remaining_time--;
-                fprintf(output, "<time %d> process %d is running\n", current_time, current_process->pid);
+                TRACE(output, "<time %d> process %d is running\n", current_time, current_process->pid);
             }
         }
+        finish_tick(idle_time == idle_mark ? ready_front : NULL, current_time, overhead_model); // the running process is always at the front of the ready queue
         current_time++;
     }
 
@@ -442,64 +1072,83 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
     average_waiting_time /= 10.0;
     average_response_time /= 10.0;
     average_turnaround_time /= 10.0;
-    fprintf(output, "====================================================\n");
-    fprintf(output, "Average cpu usage : %.2f %%\n", average_cpu_usage);
-    fprintf(output, "Average waiting time : %.2f \n", average_waiting_time);
-    fprintf(output, "Average response time : %.2f \n", average_response_time);
-    fprintf(output, "Average turnaround time : %.2f \n", average_turnaround_time);
-    fprintf(output, "*********************************************************************************\n");
-
-    fprintf(output, "Scheduling : Preemptive Priority Scheduling with Aging\n");
-    fprintf(output, "====================================================\n");
-
-    init_process(processes, 10);
-    read_process(processes, input_filename);
+    fprintf(report, "====================================================\n");
+    fprintf(report, "Average cpu usage : %.2f %%\n", average_cpu_usage);
+    fprintf(report, "Average waiting time : %.2f \n", average_waiting_time);
+    fprintf(report, "Average response time : %.2f \n", average_response_time);
+    fprintf(report, "Average turnaround time : %.2f \n", average_turnaround_time);
+    print_io_summary(report, current_time - 1);
+    print_overhead_summary(report, current_time - 1, idle_time);
+    fprintf(report, "*********************************************************************************\n");
+}
 
-    // Sort processes array by arrival time using bubble sort
-    for (int i = 0; i < 10 - 1; i++)
+void simulate_priority(Process processes[], float alpha, int64_t alpha_fixed, FILE* output, FILE* report)
+{
+    if (fixed_priority) // comparisons are picked at compile time as well
     {
-        for (int j = 0; j < 10 - i - 1; j++)
-        {
-            if (processes[j].arrival_time > processes[j + 1].arrival_time)
-            {
-                // Swap
-                Process temp = processes[j];
-                processes[j] = processes[j + 1];
-                processes[j + 1] = temp;
-            }
-        }
+        RUN_VARIANT(priority_loop, output, report, processes, alpha, alpha_fixed, true);
     }
-
-    completed_processes = 0;
-    current_time = 0;
-    idle_time = 0;
-    average_cpu_usage = 0;
-    average_waiting_time = 0;
-    average_response_time = 0;
-    average_turnaround_time = 0;
-
-    // Insert sorted processes into job queue
-    for (int i = 0; i < 10; i++)
+    else
     {
-        insert_process_job(&processes[i]);
+        RUN_VARIANT(priority_loop, output, report, processes, alpha, alpha_fixed, false);
     }
+}
 
-    if (alpha < 0 || alpha > 1) // defensive coding
-    {
-        perror("Error; alpha range[0~1]");
-        exit(1);
-    }
+ENGINE_INLINE void priority_loop(Process processes[], float alpha, int64_t alpha_fixed, const bool fixed_point, FILE* output, FILE* report, const bool overhead_model)
+{
+    int current_time = 0;
+    int completed_processes = 0;
+    float average_cpu_usage = 0;
+    float average_waiting_time = 0;
+    float average_response_time = 0;
+    float average_turnaround_time = 0;
+    int idle_time = 0;
 
+    load_job_queue(processes);
+    aging_alpha = alpha;
+    aging_alpha_fixed = alpha_fixed;
+    // With alpha > 0 a waiting process overtakes the non-aging running one on most ticks, and every preemption
+    // reschedules all crossovers, so the plain scan is faster there; with alpha 0 no crossover ever fires.
+    use_aging_wheel = aging_wheel_mode == -1 ? alpha_fixed == 0 : aging_wheel_mode != 0;
+    reset_aging_wheel();
+
+    fprintf(report, "Scheduling : Preemptive Priority Scheduling with Aging\n");
+    LOG_EVENT(0, 2, EV_SECTION);
+    fprintf(report, "====================================================\n");
     while (completed_processes < 10) // Priority loop
     {
+        int idle_mark = idle_time;
+        wake_io_processes(output, current_time);
+        if (overhead_model && in_switch_overhead()) // cpu is busy switching, the running process does not progress
+        {
+            if (use_aging_wheel)
+            {
+                age_ready_queue(current_time);
+            }
+            else
+            {
+                increase_waiting_time();
+            }
+            spend_switch_overhead(output, current_time);
+            current_time++;
+            continue;
+        }
+
         Process* current_process = ready_front;
         Process* arrived_process = job_front;
 
-        increase_waiting_time();
-
-        if (current_process == NULL && ready_front == NULL && job_front->arrival_time != current_time)
+        if (use_aging_wheel) // aging is bookkept lazily, the wheel flags the ticks where a preemption can happen
         {
-            fprintf(output, "<time %d> ---- system is idle ----\n", current_time);
+            age_ready_queue(current_time);
+        }
+        else
+        {
+            increase_waiting_time();
+        }
+
+        if (current_process == NULL && ready_front == NULL && (job_front == NULL || job_front->arrival_time != current_time))
+        {
+            TRACE(output, "<time %d> ---- system is idle ----\n", current_time);
             idle_time++;
         }
 
@@ -507,13 +1156,15 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
 
         if (job_front != NULL && job_front->arrival_time == current_time)
         {
-            fprintf(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+            TRACE(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+            LOG_EVENT(current_time, arrived_process->pid, EV_ARRIVAL);
 	        remove_from_job(arrived_process);
             insert_process_ready(arrived_process);
 	        arrived_process->priority = arrived_process->base_priority;
+	        arrived_process->priority_fixed = arrived_process->base_priority_fixed;
 	        if(current_process != NULL)
 	        {
-		            if((arrived_process->priority > current_process->priority) && (ready_front != NULL) && (ready_front->next != NULL))
+		            if((current_process->remaining_time != 0) && outranks(arrived_process, current_process, fixed_point) && (ready_front != NULL) && (ready_front->next != NULL))
                     {
                         Process* temp_p = ready_front;
                     	Process* prev = temp_p;
@@ -530,7 +1181,7 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
            		        {
                 		    current_process->response_time = (current_time-2)-current_process->arrival_time;
             		    }	
-			            fprintf(output, "------------------------------ (Context-Switch)\n");
+			            context_switch(output);
             	     }
 	                 else
 		             {
@@ -545,18 +1196,20 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
             if (job_front != NULL)
             {
                 arrived_process = job_front;
-                if (arrived_process->arrival_time == current_time && arrived_process->next != NULL)
+                if (job_front != NULL && arrived_process->arrival_time == current_time)
                 {
                     same_arrival = true;
                     while (same_arrival == true)
                     {
-                        fprintf(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+                        TRACE(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+                        LOG_EVENT(current_time, arrived_process->pid, EV_ARRIVAL);
                         remove_from_job(arrived_process);
                         insert_process_ready(arrived_process);
                         arrived_process->priority = arrived_process->base_priority;
+                        arrived_process->priority_fixed = arrived_process->base_priority_fixed;
                         if (current_process != NULL)
                         {
-                            if ((arrived_process->priority > current_process->priority) && (ready_front != NULL) && (ready_front->next != NULL))
+                            if ((current_process->remaining_time != 0) && outranks(arrived_process, current_process, fixed_point) && (ready_front != NULL) && (ready_front->next != NULL))
                             {
                                 Process* temp_p = ready_front;
                                 Process* prev = temp_p;
@@ -573,7 +1226,7 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
                                 {
                                     current_process->response_time = (current_time - 2) - current_process->arrival_time;
                                 }
-                                fprintf(output, "------------------------------ (Context-Switch)\n");
+                                context_switch(output);
                             }
                             else
                             {
@@ -614,27 +1267,35 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
 
             if (current_process->remaining_time == 0 && ready_front->next != NULL)
             {
-                // Process has completed
-                average_waiting_time += (current_time)-current_process->arrival_time - current_process->burst_time;
-                average_response_time += current_process->response_time;
-                average_turnaround_time += (current_time)-current_process->arrival_time;
-                completed_processes++;
+                bool blocked = has_io_burst(current_process); // CPU burst is over, but the process still has I/O to do
+
+                if (blocked)
+                {
+                    TRACE(output, "<time %d> process %d is blocked on device %d[priority %.2f]\n", current_time, current_process->pid, current_process->io_device[current_process->current_burst], shown_priority(current_process));
+                }
+                else
+                {
+                    // Process has completed
+                    average_waiting_time += (current_time)-current_process->arrival_time - current_process->burst_time - current_process->io_time;
+                    average_response_time += current_process->response_time;
+                    average_turnaround_time += (current_time)-current_process->arrival_time;
+                    LOG_FINISH(current_time, current_process->pid, current_process->response_time);
+                    completed_processes++;
+                }
 
                 if (completed_processes != 10)
                 {
-                    fprintf(output, "<time %d> process %d is finished[priority %.2f]\n", current_time, current_process->pid, current_process->priority);
-                    Process* p = ready_front->next;
-                    Process* highest_priority_process = p;
-                    while (p != NULL)
+                    if (!blocked)
                     {
-                        if (p->priority > highest_priority_process->priority)
-                        {
-                            highest_priority_process = p;
-                        }
-                        p = p->next;
+                        TRACE(output, "<time %d> process %d is finished[priority %.2f]\n", current_time, current_process->pid, shown_priority(current_process));
                     }
+                    Process* highest_priority_process = highest_waiting_process(current_time);
                     // Move all processes in front of highest_priority_process to the end of the ready queue
 		            remove_from_ready(current_process);
+                    if (blocked)
+                    {
+                        block_process(current_process, current_time);
+                    }
                     while (ready_front != highest_priority_process)
                     {
                         Process* moving_process = ready_front;
@@ -645,61 +1306,74 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
                     // Now, the highest_priority_process is at the front of the ready queue
                     current_process = highest_priority_process;
 
-                    fprintf(output, "------------------------------ (Context-Switch)\n");
-                    fprintf(output, "<time %d> process %d is running[priority %.2f]\n", current_time, current_process->pid, current_process->priority);
+                    context_switch(output);
+                    TRACE(output, "<time %d> process %d is running[priority %.2f]\n", current_time, current_process->pid, shown_priority(current_process));
                     current_process->remaining_time--;
                 }
                 else
                 {
-                    fprintf(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
-                    fprintf(output, "<time %d> all processes finish\n", current_time);
+                    TRACE(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
+                    TRACE(output, "<time %d> all processes finish\n", current_time);
                     remove_from_ready(current_process);
                 }
                 
             }
             else if(current_process->remaining_time == 0 && ready_front->next == NULL)
             {
-                // Process has completed
-                average_waiting_time += (current_time)-current_process->arrival_time - current_process->burst_time;
-                average_response_time += current_process->response_time;
-                average_turnaround_time += (current_time)-current_process->arrival_time;
-                completed_processes++;
+                bool blocked = has_io_burst(current_process); // CPU burst is over, but the process still has I/O to do
+
+                if (blocked)
+                {
+                    TRACE(output, "<time %d> process %d is blocked on device %d[priority %.2f]\n", current_time, current_process->pid, current_process->io_device[current_process->current_burst], shown_priority(current_process));
+                }
+                else
+                {
+                    // Process has completed
+                    average_waiting_time += (current_time)-current_process->arrival_time - current_process->burst_time - current_process->io_time;
+                    average_response_time += current_process->response_time;
+                    average_turnaround_time += (current_time)-current_process->arrival_time;
+                    LOG_FINISH(current_time, current_process->pid, current_process->response_time);
+                    completed_processes++;
+                }
 
                 if (completed_processes != 10)
                 {
-                    fprintf(output, "<time %d> process %d is finished[priority %.2f]\n", current_time, current_process->pid, current_process->priority);
+                    if (!blocked)
+                    {
+                        TRACE(output, "<time %d> process %d is finished[priority %.2f]\n", current_time, current_process->pid, shown_priority(current_process));
+                    }
                     current_process = ready_front;
-                    fprintf(output, "<time %d> ---- system is idle ----\n", current_time);
+                    TRACE(output, "<time %d> ---- system is idle ----\n", current_time);
                     idle_time++;
                 }
                 else
                 {
-                    fprintf(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
-                    fprintf(output, "<time %d> all processes finish\n", current_time);
+                    TRACE(output, "<time %d> process %d is finished\n", current_time, current_process->pid);
+                    TRACE(output, "<time %d> all processes finish\n", current_time);
                 }
                 remove_from_ready(current_process);
+                if (blocked)
+                {
+                    block_process(current_process, current_time);
+                }
             }
             else if (current_process->remaining_time != 0)
             {
                 if (ready_front->next == NULL)
                 {
-                    fprintf(output, "<time %d> process %d is running[priority %.2f]\n", current_time, current_process->pid, current_process->priority);
+                    TRACE(output, "<time %d> process %d is running[priority %.2f]\n", current_time, current_process->pid, shown_priority(current_process));
                     current_process->remaining_time--;
                 }
                 else
                 {
-                    Process* p = ready_front->next;
-                    Process* highest_priority_process = p;
-                    while (p != NULL)
+                    Process* highest_priority_process = NULL;
+                    if (!use_aging_wheel || preemption_check) // between crossovers nobody can outrank the running process
                     {
-                        if (p->priority > highest_priority_process->priority)
-                        {
-                            highest_priority_process = p;
-                        }
-                        p = p->next;
+                        highest_priority_process = highest_waiting_process(current_time);
+                        preemption_check = false;
                     }
 
-                    if (current_process->priority < highest_priority_process->priority)
+                    if (highest_priority_process != NULL && outranks(highest_priority_process, current_process, fixed_point))
                     {
                         // Move all processes in front of highest_priority_process to the end of the ready queue
                         while (ready_front != highest_priority_process)
@@ -712,144 +1386,2126 @@ void simulate(Process processes[], int quantum, float alpha, char* output_file)
                         // Now, the highest_priority_process is at the front of the ready queue
                         current_process = highest_priority_process;
 
-                        fprintf(output, "------------------------------ (Context-Switch)\n");
-                        fprintf(output, "<time %d> process %d is running[priority %.2f]\n", current_time, current_process->pid,current_process->priority);
+                        context_switch(output);
+                        TRACE(output, "<time %d> process %d is running[priority %.2f]\n", current_time, current_process->pid, shown_priority(current_process));
                         current_process->remaining_time--;
                     }
                     else
                     {
-                        fprintf(output, "<time %d> process %d is running[priority %.2f]\n", current_time, current_process->pid, current_process->priority);
+                        TRACE(output, "<time %d> process %d is running[priority %.2f]\n", current_time, current_process->pid, shown_priority(current_process));
                         current_process->remaining_time--;
                     }
                 }
             }
 
         }
+        finish_tick(idle_time == idle_mark ? ready_front : NULL, current_time, overhead_model); // the running process is always at the front of the ready queue
         current_time++;
     }
     average_cpu_usage = ((float)(current_time-1 - idle_time)) / (current_time-1) * 100;
     average_waiting_time /= 10.0;
     average_response_time /= 10.0;
     average_turnaround_time /= 10.0;
-    fprintf(output, "====================================================\n");
-    fprintf(output, "Average cpu usage : %.2f %%\n", average_cpu_usage);
-    fprintf(output, "Average waiting time : %.2f \n", average_waiting_time);
-    fprintf(output, "Average response time : %.2f \n", average_response_time);
-    fprintf(output, "Average turnaround time : %.2f \n", average_turnaround_time);
-    fprintf(output, "*********************************************************************************\n");
-    fclose(output);
+    fprintf(report, "====================================================\n");
+    fprintf(report, "Average cpu usage : %.2f %%\n", average_cpu_usage);
+    fprintf(report, "Average waiting time : %.2f \n", average_waiting_time);
+    fprintf(report, "Average response time : %.2f \n", average_response_time);
+    fprintf(report, "Average turnaround time : %.2f \n", average_turnaround_time);
+    print_io_summary(report, current_time - 1);
+    print_overhead_summary(report, current_time - 1, idle_time);
+    fprintf(report, "*********************************************************************************\n");
 }
 
-void increase_waiting_time() // Increase value of time in ready queue
+void simulate_edf(Process processes[], FILE* output, FILE* report) // Earliest deadline first, preemptive
 {
-    if (ready_front == NULL || ready_front->next == NULL)
+    RUN_VARIANT(realtime_loop, output, report, processes, true);
+}
+
+void simulate_rm(Process processes[], FILE* output, FILE* report) // Rate-Monotonic : static priority, shorter period first
+{
+    RUN_VARIANT(realtime_loop, output, report, processes, false);
+}
+
+// Periodic tasks release a job of burst_time every period from their arrival until the hyperperiod ends, tasks
+// without a period release a single job. The pending tasks sit in a min-heap keyed by the absolute deadline of their
+// oldest job(EDF) or by period(RM), and the top of the heap runs every tick. I/O bursts are ignored : a job's demand
+// is the sum of the task's CPU bursts, and jobs never block.
+ENGINE_INLINE void realtime_loop(Process processes[], bool edf, FILE* output, FILE* report, const bool overhead_model)
+{
+    int current_time = 0;
+    int completed_jobs = 0;
+    int deadline_misses = 0;
+    int deadline_jobs = 0;
+    float average_cpu_usage = 0;
+    float average_waiting_time = 0;
+    float average_response_time = 0;
+    float average_turnaround_time = 0;
+    int idle_time = 0;
+    Process* running = NULL; // process that had the cpu on the last tick
+    int next_event = 0; // next release or deadline
+    bool releases_left = true;
+
+    job_front = NULL;
+    job_rear = NULL;
+    ready_front = NULL;
+    ready_rear = NULL;
+    num_devices = 0; // jobs do not block on I/O
+    reset_overhead();
+    rt_edf = edf;
+    rt_heap_size = 0;
+    rt_horizon = realtime_horizon(processes);
+    for (int i = 0; i < LATENESS_BUCKETS; i++)
     {
-        return;
+        lateness_buckets[i] = 0;
     }
 
-    Process* temp = ready_front->next; // Start from the second process in the queue
+    fprintf(report, "Scheduling : %s\n", edf ? "EDF" : "RM");
+    LOG_EVENT(0, edf ? 3 : 4, EV_SECTION);
+    fprintf(report, "====================================================\n");
+    while (true) // real-time loop
+    {
+        if (running != NULL && running->job_start != -1 && running->remaining_time == 0) // the job that ran last is done
+        {
+            int release = job_release(running, running->jobs_done);
+            int turnaround = current_time - release;
+
+            average_waiting_time += turnaround - running->burst_time;
+            average_response_time += running->job_start - release;
+            average_turnaround_time += turnaround;
+            LOG_FINISH(current_time, running->pid, running->job_start - release);
+            if (running->relative_deadline > 0)
+            {
+                deadline_jobs++;
+                deadline_misses += current_time > job_deadline(running);
+                record_lateness(running, current_time - job_deadline(running));
+            }
+            completed_jobs++;
+            TRACE(output, "<time %d> process %d is finished[job %d]\n", current_time, running->pid, running->jobs_done);
 
-    while (temp != NULL)
+            rt_heap_pop(); // nothing was released since it was picked, so it is still the top of the heap
+            running->jobs_done++;
+            running->job_start = -1;
+            if (running->jobs_done < running->jobs_released) // next job was released while this one ran
+            {
+                running->remaining_time = running->burst_time;
+                rt_heap_push(running);
+            }
+        }
+
+        if (current_time >= next_event) // tasks are only scanned on ticks with a release or a deadline
+        {
+            releases_left = false;
+            next_event = INT_MAX;
+            for (int i = 0; i < 10; i++)
+            {
+                Process* p = &processes[i];
+                if (next_release(p) == current_time)
+                {
+                    if (p->relative_deadline > 0)
+                    {
+                        TRACE(output, "<time %d> [new arrival] process %d[job %d, deadline %d]\n", current_time, p->pid, p->jobs_released, current_time + p->relative_deadline);
+                    }
+                    else
+                    {
+                        TRACE(output, "<time %d> [new arrival] process %d\n", current_time, p->pid);
+                    }
+                    LOG_EVENT(current_time, p->pid, EV_ARRIVAL);
+                    p->jobs_released++;
+                    if (p->jobs_released == p->jobs_done + 1) // no older job pending, the task enters the heap
+                    {
+                        p->remaining_time = p->burst_time;
+                        p->job_start = -1;
+                        rt_heap_push(p);
+                    }
+                }
+                if (next_deadline(p, current_time - 1) == current_time)
+                {
+                    TRACE(output, "<time %d> process %d missed its deadline[job %d]\n", current_time, p->pid,
+                        p->period > 0 ? (current_time - p->relative_deadline - p->arrival_time) / p->period : 0);
+                    LOG_EVENT(current_time, p->pid, EV_MISS);
+                }
+
+                int release = next_release(p);
+                int deadline = next_deadline(p, current_time);
+                releases_left = releases_left || release != -1;
+                if (release != -1 && release < next_event)
+                {
+                    next_event = release;
+                }
+                if (deadline < next_event)
+                {
+                    next_event = deadline;
+                }
+            }
+        }
+
+        if (rt_heap_size == 0 && !releases_left)
+        {
+            TRACE(output, "<time %d> all processes finish\n", current_time);
+            break;
+        }
+
+        if (overhead_model && in_switch_overhead()) // cpu is busy switching, the running process does not progress
+        {
+            spend_switch_overhead(output, current_time);
+            current_time++;
+            continue;
+        }
+
+        Process* current_process = rt_heap_size > 0 ? rt_heap[0] : NULL;
+        if (current_process == NULL)
+        {
+            TRACE(output, "<time %d> ---- system is idle ----\n", current_time);
+            idle_time++;
+        }
+        else
+        {
+            if (running != NULL && running != current_process) // preempted, or the last job finished
+            {
+                context_switch(output);
+            }
+            if (current_process->job_start == -1)
+            {
+                current_process->job_start = current_time;
+            }
+            if (edf)
+            {
+                TRACE(output, "<time %d> process %d is running[deadline %d]\n", current_time, current_process->pid, job_deadline(current_process));
+            }
+            else
+            {
+                TRACE(output, "<time %d> process %d is running[period %d]\n", current_time, current_process->pid, current_process->period);
+            }
+            current_process->remaining_time--;
+        }
+        running = current_process;
+        finish_tick(current_process, current_time, overhead_model);
+        current_time++;
+    }
+    average_cpu_usage = ((float)(current_time - idle_time)) / current_time * 100;
+    if (completed_jobs > 0)
     {
-        temp->time_in_waiting += 1;
-        temp->priority = temp->base_priority + (alpha * temp->time_in_waiting);
-        temp = temp->next;
+        average_waiting_time /= completed_jobs;
+        average_response_time /= completed_jobs;
+        average_turnaround_time /= completed_jobs;
+    }
+    fprintf(report, "====================================================\n");
+    fprintf(report, "Average cpu usage : %.2f %%\n", average_cpu_usage);
+    fprintf(report, "Average waiting time : %.2f \n", average_waiting_time);
+    fprintf(report, "Average response time : %.2f \n", average_response_time);
+    fprintf(report, "Average turnaround time : %.2f \n", average_turnaround_time);
+    fprintf(report, "Completed jobs : %d\n", completed_jobs);
+    fprintf(report, "Deadline misses : %d / %d jobs\n", deadline_misses, deadline_jobs);
+    print_lateness_summary(report);
+    for (int i = 0; i < 10; i++)
+    {
+        if (processes[i].relative_deadline > 0)
+        {
+            fprintf(report, "process %d : %d jobs, %d deadline misses, max lateness %d\n", processes[i].pid,
+                processes[i].jobs_done, processes[i].deadline_misses, processes[i].max_lateness);
+        }
     }
+    print_utilization_bound(report, processes, edf);
+    print_overhead_summary(report, current_time, idle_time);
+    fprintf(report, "*********************************************************************************\n");
 }
 
+bool has_deadlines(Process processes[]) // true if any process is a real-time task
+{
+    for (int i = 0; i < 10; i++)
+    {
+        if (processes[i].relative_deadline > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
 
-void insert_process_job(Process* process)
+int realtime_horizon(Process processes[]) // One hyperperiod after the last periodic task arrives
 {
-    if (process == NULL)
+    long hyperperiod = 1;
+    int last_arrival = 0;
+
+    for (int i = 0; i < 10; i++)
     {
-        fprintf(stderr, "Error: Process is NULL\n");
-        return;
+        int period = processes[i].period;
+        if (period == 0)
+        {
+            continue;
+        }
+        long a = hyperperiod, b = period;
+        while (b != 0) // gcd
+        {
+            long r = a % b;
+            a = b;
+            b = r;
+        }
+        hyperperiod = hyperperiod / a * period;
+        if (hyperperiod > RT_HORIZON_LIMIT)
+        {
+            hyperperiod = RT_HORIZON_LIMIT;
+        }
+        if (processes[i].arrival_time > last_arrival)
+        {
+            last_arrival = processes[i].arrival_time;
+        }
     }
 
-    if (job_front == NULL)
+    if (last_arrival + hyperperiod > RT_HORIZON_LIMIT)
     {
-        job_front = process;
-        job_rear = process;
+        return RT_HORIZON_LIMIT;
     }
-    else
+    return last_arrival + hyperperiod;
+}
+
+int job_release(Process* process, int job) // release time of the job-th job of the task
+{
+    return process->arrival_time + job * process->period;
+}
+
+int job_deadline(Process* process) // absolute deadline of the oldest unfinished job, INT_MAX if the task has none
+{
+    if (process->relative_deadline == 0)
     {
-        job_rear->next = process;
-        job_rear = process;
+        return INT_MAX;
     }
+    return job_release(process, process->jobs_done) + process->relative_deadline;
 }
 
-void insert_process_ready(Process* process)
+int next_release(Process* process) // time of the next job release, -1 if the task releases no more jobs
 {
-    if (process == NULL)
+    if (process->jobs_released == 0)
     {
-        fprintf(stderr, "Error: Process is NULL\n");
-        return;
+        return process->arrival_time;
     }
+    int release = job_release(process, process->jobs_released);
+    if (process->period == 0 || release >= rt_horizon)
+    {
+        return -1;
+    }
+    return release;
+}
 
-    process->next = NULL;
+int next_deadline(Process* process, int current_time) // first deadline after current_time of an unfinished job, INT_MAX if none
+{
+    if (process->relative_deadline == 0 || process->jobs_done == process->jobs_released)
+    {
+        return INT_MAX;
+    }
+    int job = process->jobs_done;
+    if (process->period > 0 && job_release(process, job) + process->relative_deadline <= current_time)
+    {
+        job = (current_time - process->relative_deadline - process->arrival_time) / process->period + 1;
+    }
+    if (job >= process->jobs_released || job_release(process, job) + process->relative_deadline <= current_time)
+    {
+        return INT_MAX;
+    }
+    return job_release(process, job) + process->relative_deadline;
+}
 
-    if (ready_front == NULL)
+bool rt_before(Process* a, Process* b) // Heap order : earlier deadline(EDF) or shorter period(RM), then lower pid
+{
+    int key_a, key_b;
+    if (rt_edf)
     {
-        ready_front = process;
-        ready_rear = process;
+        key_a = job_deadline(a);
+        key_b = job_deadline(b);
     }
     else
     {
-        ready_rear->next = process;
-        ready_rear = process;
+        key_a = a->period > 0 ? a->period : INT_MAX; // one-shot jobs run in the background
+        key_b = b->period > 0 ? b->period : INT_MAX;
     }
+    return key_a < key_b || (key_a == key_b && a->pid < b->pid);
 }
 
-void remove_from_job(Process* process)
+void rt_heap_push(Process* process)
 {
-    if (process == NULL)
+    int i = rt_heap_size++;
+    while (i > 0 && rt_before(process, rt_heap[(i - 1) / 2]))
     {
-        fprintf(stderr, "Error: Process is NULL\n");
-        return;
+        rt_heap[i] = rt_heap[(i - 1) / 2];
+        i = (i - 1) / 2;
     }
+    rt_heap[i] = process;
+}
 
-    if (job_front == process)
+void rt_heap_pop() // Remove the top of the heap
+{
+    Process* last = rt_heap[--rt_heap_size];
+    int i = 0;
+    while (2 * i + 1 < rt_heap_size)
     {
-        job_front = job_front->next;
-
-        if (job_front == NULL)
+        int child = 2 * i + 1;
+        if (child + 1 < rt_heap_size && rt_before(rt_heap[child + 1], rt_heap[child]))
         {
-            job_rear = NULL;
+            child++;
+        }
+        if (!rt_before(rt_heap[child], last))
+        {
+            break;
         }
+        rt_heap[i] = rt_heap[child];
+        i = child;
     }
+    rt_heap[i] = last;
 }
 
-void remove_from_ready(Process* process)
+void record_lateness(Process* process, int lateness) // Count a finished job in the lateness distribution
 {
-    if (process == NULL)
+    int bucket = 0;
+    if (lateness > 0)
     {
-        fprintf(stderr, "Error: Process is NULL\n");
-        return;
+        process->deadline_misses++;
+        bucket = 1;
+        while (bucket < LATENESS_BUCKETS - 1 && (lateness >> bucket) > 0)
+        {
+            bucket++;
+        }
+    }
+    if (lateness > process->max_lateness)
+    {
+        process->max_lateness = lateness;
     }
+    lateness_buckets[bucket]++;
+}
 
-    if (ready_front == process)
+void print_lateness_summary(FILE* output) // Lateness distribution of the finished jobs with a deadline
+{
+    fprintf(output, "Lateness distribution : on time %d", lateness_buckets[0]);
+    for (int i = 1; i < LATENESS_BUCKETS; i++)
     {
-        ready_front = ready_front->next;
+        if (lateness_buckets[i] > 0)
+        {
+            fprintf(output, ", %d~%d : %d", 1 << (i - 1), (1 << i) - 1, lateness_buckets[i]);
+        }
+    }
+    fprintf(output, "\n");
+}
 
-        if (ready_front == NULL)
+void print_utilization_bound(FILE* output, Process processes[], bool edf) // Schedulability tests of the periodic tasks
+{
+    double utilization = 0; // summed in double and compared with a tolerance, so a full cpu is not taken for an overload
+    double density = 0; // like utilization, with the deadline in place of a longer period
+    double hyperbolic = 1;
+    const double tolerance = 1e-9;
+    int periodic_tasks = 0;
+    bool constrained = false; // some deadline is shorter than its period
+
+    for (int i = 0; i < 10; i++)
+    {
+        if (processes[i].period == 0)
         {
-            ready_rear = NULL;
+            continue;
         }
+        double u = (double)processes[i].burst_time / processes[i].period;
+        int window = processes[i].relative_deadline < processes[i].period ? processes[i].relative_deadline : processes[i].period;
+        utilization += u;
+        density += (double)processes[i].burst_time / window;
+        hyperbolic *= 1 + u;
+        periodic_tasks++;
+        constrained = constrained || processes[i].relative_deadline < processes[i].period;
+    }
+    if (periodic_tasks == 0)
+    {
+        return;
+    }
+
+    if (edf)
+    {
+        fprintf(output, "Utilization : %.2f, density : %.2f (EDF bound 1.00 : %s)\n", utilization, density,
+            density <= 1 + tolerance ? "schedulable" : utilization <= 1 + tolerance ? "not guaranteed" : "overloaded");
+    }
+    else if (constrained) // the utilization bounds assume deadlines no shorter than periods
+    {
+        fprintf(output, "Utilization : %.2f (Liu-Layland bound : not applicable, response-time analysis : %s)\n", utilization,
+            rm_response_times_fit(processes) ? "schedulable" : utilization <= 1 + tolerance ? "not guaranteed" : "overloaded");
     }
     else
     {
-        Process* temp = ready_front;
-        while (temp->next != NULL && temp->next != process)
+        double bound = liu_layland_bound[periodic_tasks - 1];
+        fprintf(output, "Utilization : %.2f (Liu-Layland bound %.2f : %s, hyperbolic bound : %s)\n", utilization, bound,
+            utilization <= bound + tolerance ? "schedulable" : utilization <= 1 + tolerance ? "not guaranteed" : "overloaded",
+            hyperbolic <= 2 + tolerance ? "schedulable" : "not guaranteed");
+    }
+}
+
+bool rm_response_times_fit(Process processes[]) // Worst-case response time of every periodic task within its deadline, under RM
+{
+    for (int i = 0; i < 10; i++)
+    {
+        Process* task = &processes[i];
+        if (task->period == 0)
         {
-            temp = temp->next;
+            continue;
         }
-        if (temp->next != NULL)
+        int deadline = task->relative_deadline < task->period ? task->relative_deadline : task->period;
+
+        // all tasks released together, the critical instant : R = C + sum of ceil(R / T) * C over the tasks ahead in RM order
+        long response = task->burst_time;
+        long previous = 0;
+        while (response != previous && response <= deadline)
         {
-            temp->next = temp->next->next;
-            if (temp->next == NULL)
+            previous = response;
+            response = task->burst_time;
+            for (int j = 0; j < 10; j++)
             {
-                ready_rear = temp;
+                if (j != i && processes[j].period > 0 && rt_before(&processes[j], task))
+                {
+                    response += (previous + processes[j].period - 1) / processes[j].period * processes[j].burst_time;
+                }
+            }
+        }
+        if (response > deadline)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void simulate_group(Process processes[], int policy, int quantum, FILE* output, FILE* report) // Fair share between groups, policy inside each
+{
+    RUN_VARIANT(group_loop, output, report, processes, policy, quantum);
+}
+
+// Hierarchical fair share : a group gains GROUP_STRIDE / weight of virtual runtime per tick it holds the cpu, and the
+// group with the least virtual runtime gets the next slice of up to quantum ticks. Only groups with a ready member
+// sit in the min-heap, so a pick costs O(log groups) and waiting or blocked groups are never scanned; a group that
+// wakes up starts at the virtual runtime of the last pick instead of cashing in the time it was away. Inside the group
+// the front of its ready list runs : arrival order(FCFS), rotated after each slice(RR) or base priority(PRIO).
+ENGINE_INLINE void group_loop(Process processes[], int policy, int quantum, FILE* output, FILE* report, const bool overhead_model)
+{
+    int current_time = 0;
+    int completed_processes = 0;
+    float average_cpu_usage = 0;
+    float average_waiting_time = 0;
+    float average_response_time = 0;
+    float average_turnaround_time = 0;
+    int idle_time = 0;
+    Process* running = NULL; // process that had the cpu on the last tick
+    Process* burst_over = NULL; // process whose CPU burst ended on the last tick
+    Group* running_group = NULL; // group of the slice in progress, NULL to pick one
+    int slice = 0; // ticks of the slice in progress
+
+    load_job_queue(processes);
+    group_policy = policy;
+    load_groups(processes);
+
+    fprintf(report, "Scheduling : Group fair share(%s inside groups)\n", section_names[policy]);
+    LOG_EVENT(0, 5 + policy, EV_SECTION);
+    fprintf(report, "====================================================\n");
+    while (true) // group loop
+    {
+        if (burst_over != NULL)
+        {
+            Process* process = burst_over;
+            Group* group = &groups[process->group_slot];
+
+            burst_over = NULL;
+            running_group = NULL; // the slice ends with the burst
+            group_dequeue(process);
+            if (has_io_burst(process))
+            {
+                TRACE(output, "<time %d> process %d is blocked on device %d\n", current_time, process->pid, process->io_device[process->current_burst]);
+                block_process(process, current_time);
+            }
+            else
+            {
+                int turnaround = current_time - process->arrival_time;
+                int waiting = turnaround - process->burst_time - process->io_time;
+
+                average_waiting_time += waiting;
+                average_response_time += process->response_time;
+                average_turnaround_time += turnaround;
+                group->waiting_time += waiting;
+                group->response_time += process->response_time;
+                group->turnaround_time += turnaround;
+                LOG_FINISH(current_time, process->pid, process->response_time);
+                completed_processes++;
+                TRACE(output, "<time %d> process %d is finished\n", current_time, process->pid);
             }
         }
+        if (completed_processes == 10)
+        {
+            TRACE(output, "<time %d> all processes finish\n", current_time);
+            break;
+        }
+
+        wake_io_processes(output, current_time);
+        admit_arrivals(output, current_time);
+        while (ready_front != NULL) // arrivals and I/O completions join the ready list of their group
+        {
+            Process* process = ready_front;
+            remove_from_ready(process);
+            group_enqueue(process);
+        }
+
+        if (overhead_model && in_switch_overhead()) // cpu is busy switching, the running process does not progress
+        {
+            spend_switch_overhead(output, current_time);
+            current_time++;
+            continue;
+        }
+
+        if (running_group != NULL && slice >= quantum)
+        {
+            if (policy == GROUP_RR && running_group->front != running_group->rear)
+            {
+                Process* process = running_group->front;
+                group_dequeue(process);
+                group_enqueue(process);
+            }
+            running_group = NULL;
+        }
+        if (running_group == NULL && group_heap_size > 0)
+        {
+            running_group = group_heap[0];
+            slice = 0;
+            if (running_group->vruntime > group_clock)
+            {
+                group_clock = running_group->vruntime;
+            }
+        }
+
+        Process* current_process = running_group != NULL ? running_group->front : NULL;
+        if (current_process == NULL)
+        {
+            TRACE(output, "<time %d> ---- system is idle ----\n", current_time);
+            idle_time++;
+        }
+        else
+        {
+            if (running != NULL && running != current_process) // another group's slice, or preempted inside the group
+            {
+                context_switch(output);
+            }
+            if (current_process->response_time == -1)
+            {
+                current_process->response_time = current_time - current_process->arrival_time;
+            }
+            TRACE(output, "<time %d> process %d is running[group %d]\n", current_time, current_process->pid, running_group->id);
+            current_process->remaining_time--;
+            if (current_process->remaining_time <= 0)
+            {
+                burst_over = current_process;
+            }
+            running_group->cpu_time++;
+            running_group->vruntime += GROUP_STRIDE / running_group->weight;
+            running_group->vruntime_remainder += GROUP_STRIDE % running_group->weight;
+            if (running_group->vruntime_remainder >= running_group->weight)
+            {
+                running_group->vruntime++;
+                running_group->vruntime_remainder -= running_group->weight;
+            }
+            group_heap_down(running_group);
+            slice++;
+        }
+        running = current_process;
+        finish_tick(current_process, current_time, overhead_model);
+        current_time++;
+    }
+    average_cpu_usage = ((float)(current_time - idle_time)) / current_time * 100;
+    average_waiting_time /= 10.0;
+    average_response_time /= 10.0;
+    average_turnaround_time /= 10.0;
+    fprintf(report, "====================================================\n");
+    fprintf(report, "Average cpu usage : %.2f %%\n", average_cpu_usage);
+    fprintf(report, "Average waiting time : %.2f \n", average_waiting_time);
+    fprintf(report, "Average response time : %.2f \n", average_response_time);
+    fprintf(report, "Average turnaround time : %.2f \n", average_turnaround_time);
+    print_io_summary(report, current_time);
+    print_overhead_summary(report, current_time, idle_time);
+    print_group_summary(report);
+    fprintf(report, "*********************************************************************************\n");
+}
+
+bool has_groups(Process processes[]) // true if any process carries a group id
+{
+    for (int i = 0; i < 10; i++)
+    {
+        if (processes[i].group != -1)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void load_groups(Process processes[]) // Collect the groups of a workload before a group run, processes without an id join group 0
+{
+    num_groups = 0;
+    group_heap_size = 0;
+    group_clock = 0;
+
+    for (int i = 0; i < 10; i++)
+    {
+        int id = processes[i].group == -1 ? 0 : processes[i].group;
+        int slot = 0;
+        while (slot < num_groups && groups[slot].id != id)
+        {
+            slot++;
+        }
+        if (slot == num_groups)
+        {
+            groups[slot] = (Group){ id, 1, 0, 0, NULL, NULL, -1, 0, 0, 0, 0, 0 };
+            num_groups++;
+        }
+        if (processes[i].group_weight > 0)
+        {
+            groups[slot].weight = processes[i].group_weight;
+        }
+        groups[slot].members++;
+        processes[i].group_slot = slot;
+    }
+}
+
+void group_enqueue(Process* process) // Add a ready process to its group, the group joins the heap if it had no ready member
+{
+    Group* group = &groups[process->group_slot];
+    Process** link = group->rear != NULL ? &group->rear->next : &group->front;
+
+    if (group_policy == GROUP_PRIO) // behind every member of the same or a higher priority
+    {
+        link = &group->front;
+        while (*link != NULL && !(fixed_priority ? process->base_priority_fixed > (*link)->base_priority_fixed : process->base_priority > (*link)->base_priority))
+        {
+            link = &(*link)->next;
+        }
+    }
+    process->next = *link;
+    *link = process;
+    if (process->next == NULL)
+    {
+        group->rear = process;
+    }
+
+    if (group->heap_index == -1)
+    {
+        if (group->vruntime < group_clock)
+        {
+            group->vruntime = group_clock;
+            group->vruntime_remainder = 0;
+        }
+        group_heap_place(group, group_heap_size++);
+        group_heap_up(group);
+    }
+}
+
+void group_dequeue(Process* process) // Remove a process from the ready list of its group, the group leaves the heap once empty
+{
+    Group* group = &groups[process->group_slot];
+    Process* previous = NULL;
+    Process** link = &group->front;
+
+    while (*link != NULL && *link != process)
+    {
+        previous = *link;
+        link = &(*link)->next;
+    }
+    if (*link == NULL)
+    {
+        fprintf(stderr, "Error: Process is not in its group\n");
+        return;
+    }
+    *link = process->next;
+    process->next = NULL;
+    if (group->rear == process)
+    {
+        group->rear = previous;
+    }
+
+    if (group->front == NULL)
+    {
+        group_heap_remove(group);
+    }
+}
+
+bool group_before(Group* a, Group* b) // Heap order : less virtual runtime(compared exactly, remainders included), then lower group id
+{
+    if (a->vruntime != b->vruntime)
+    {
+        return a->vruntime < b->vruntime;
+    }
+    int64_t fraction_a = (int64_t)a->vruntime_remainder * b->weight; // a->vruntime_remainder / a->weight against b's
+    int64_t fraction_b = (int64_t)b->vruntime_remainder * a->weight;
+    return fraction_a < fraction_b || (fraction_a == fraction_b && a->id < b->id);
+}
+
+void group_heap_place(Group* group, int index)
+{
+    group_heap[index] = group;
+    group->heap_index = index;
+}
+
+void group_heap_up(Group* group) // Restore the heap order after the group was added
+{
+    int i = group->heap_index;
+    while (i > 0 && group_before(group, group_heap[(i - 1) / 2]))
+    {
+        group_heap_place(group_heap[(i - 1) / 2], i);
+        i = (i - 1) / 2;
+    }
+    group_heap_place(group, i);
+}
+
+void group_heap_down(Group* group) // Restore the heap order after the virtual runtime of the group grew
+{
+    int i = group->heap_index;
+    while (2 * i + 1 < group_heap_size)
+    {
+        int child = 2 * i + 1;
+        if (child + 1 < group_heap_size && group_before(group_heap[child + 1], group_heap[child]))
+        {
+            child++;
+        }
+        if (!group_before(group_heap[child], group))
+        {
+            break;
+        }
+        group_heap_place(group_heap[child], i);
+        i = child;
+    }
+    group_heap_place(group, i);
+}
+
+void group_heap_remove(Group* group)
+{
+    Group* last = group_heap[--group_heap_size];
+    int i = group->heap_index;
+
+    group->heap_index = -1;
+    if (last != group) // the last leaf fills the hole, then moves up or down
+    {
+        group_heap_place(last, i);
+        group_heap_up(last);
+        group_heap_down(last);
+    }
+}
+
+void print_group_summary(FILE* output) // Per-group lines of the report : cpu time received against the weight
+{
+    int total_weight = 0;
+    int total_cpu_time = 0;
+
+    for (int i = 0; i < num_groups; i++)
+    {
+        total_weight += groups[i].weight;
+        total_cpu_time += groups[i].cpu_time;
+    }
+    for (int i = 0; i < num_groups; i++)
+    {
+        Group* group = &groups[i];
+        fprintf(output, "group %d : weight %d(%.2f %%), cpu time %d(%.2f %%), %d processes, average waiting %.2f, response %.2f, turnaround %.2f\n",
+            group->id, group->weight, ((float)group->weight) / total_weight * 100, group->cpu_time, ((float)group->cpu_time) / total_cpu_time * 100,
+            group->members, group->waiting_time / group->members, group->response_time / group->members, group->turnaround_time / group->members);
+    }
+}
+
+void increase_waiting_time() // Increase value of time in ready queue
+{
+    if (ready_front == NULL || ready_front->next == NULL)
+    {
+        return;
+    }
+
+    Process* temp = ready_front->next; // Start from the second process in the queue
+
+    while (temp != NULL)
+    {
+        temp->time_in_waiting += 1;
+        if (fixed_priority)
+        {
+            temp->priority_fixed = aged_priority_fixed(temp, temp->time_in_waiting);
+        }
+        else
+        {
+            temp->priority = temp->base_priority + (aging_alpha * temp->time_in_waiting);
+        }
+        temp = temp->next;
+    }
+}
+
+void reset_aging_wheel() // Empty the timing wheel before a new priority run
+{
+    for (int i = 0; i < 2 * WHEEL_SLOTS; i++)
+    {
+        aging_wheel[i] = NULL;
+    }
+    ready_insertions = 0;
+    aged_insertions = 0;
+    aged_front = NULL;
+    preemption_check = false;
+}
+
+// Lazy version of increase_waiting_time(). A waiting process ages by one on every tick, so only the start of its
+// aging streak is stored, and the bookkeeping is redone only when the ready queue changed since the last tick.
+// The aged priorities then grow in a known way, and the tick where each one first exceeds the running process is
+// put on the timing wheel; the running process is checked for preemption only when one of those ticks comes.
+void age_ready_queue(int current_time)
+{
+    advance_aging_wheel(current_time);
+
+    if (ready_insertions == aged_insertions && ready_front == aged_front)
+    {
+        return;
+    }
+    aged_insertions = ready_insertions;
+    aged_front = ready_front;
+
+    if (ready_front == NULL)
+    {
+        return;
+    }
+
+    // the running process does not age, it keeps the priority it had when the last tick ended
+    Process* running = ready_front;
+    if (running->aging_since != -1)
+    {
+        running->time_in_waiting = aged_time_in_waiting(running, current_time - 1);
+        running->aging_since = -1;
+    }
+    wheel_remove(running);
+
+    for (Process* p = running->next; p != NULL; p = p->next)
+    {
+        if (p->aging_since == -1)
+        {
+            p->aging_since = current_time;
+        }
+        schedule_crossover(p, running, current_time);
+    }
+}
+
+int aged_time_in_waiting(Process* process, int current_time) // time_in_waiting once the aging of current_time is done
+{
+    if (process->aging_since == -1 || current_time < process->aging_since)
+    {
+        return process->time_in_waiting;
+    }
+    return process->time_in_waiting + (current_time - process->aging_since + 1);
+}
+
+float aged_priority(Process* process, int time_in_waiting) // same expression as increase_waiting_time(), for identical rounding
+{
+    return process->base_priority + (aging_alpha * time_in_waiting);
+}
+
+int64_t aged_priority_fixed(Process* process, int time_in_waiting)
+{
+    return process->base_priority_fixed + aging_alpha_fixed * time_in_waiting;
+}
+
+void schedule_crossover(Process* process, Process* running, int current_time) // Put the first tick it outranks the running process on the wheel
+{
+    int time_in_waiting = aged_time_in_waiting(process, current_time);
+    float running_priority = running->priority;
+
+    wheel_remove(process);
+    if (fixed_priority) // exact : it outranks once alpha * time_in_waiting exceeds the gap
+    {
+        int64_t gap = running->priority_fixed - process->base_priority_fixed;
+        if (aged_priority_fixed(process, time_in_waiting) > running->priority_fixed)
+        {
+            preemption_check = true;
+            return;
+        }
+        if (aging_alpha_fixed <= 0 || gap / aging_alpha_fixed >= 1000000000)
+        {
+            return; // never catches up, or later than any simulated time
+        }
+        process->crossover_time = current_time + (int)(gap / aging_alpha_fixed + 1 - time_in_waiting);
+        wheel_insert(process, current_time);
+        return;
+    }
+
+    if (aged_priority(process, time_in_waiting) > running_priority)
+    {
+        preemption_check = true;
+        return;
+    }
+    if (aging_alpha <= 0)
+    {
+        return; // never catches up
+    }
+
+    // first guess from the real numbers, then settle it on the float values the loop compares
+    double guess = (running_priority - process->base_priority) / aging_alpha;
+    if (guess >= 1e9)
+    {
+        return; // later than any simulated time
+    }
+    int target = (int)guess + 1;
+    if (target <= time_in_waiting)
+    {
+        target = time_in_waiting + 1;
+    }
+    while (target > time_in_waiting + 1 && aged_priority(process, target - 1) > running_priority)
+    {
+        target--;
+    }
+    while (!(aged_priority(process, target) > running_priority))
+    {
+        target++;
+    }
+
+    process->crossover_time = current_time + (target - time_in_waiting);
+    wheel_insert(process, current_time);
+}
+
+void wheel_insert(Process* process, int current_time) // Hang the process in the slot of its crossover time
+{
+    int delta = process->crossover_time - current_time;
+    int slot;
+
+    if (delta < WHEEL_SLOTS)
+    {
+        slot = process->crossover_time % WHEEL_SLOTS;
+    }
+    else if (delta < WHEEL_SPAN)
+    {
+        slot = WHEEL_SLOTS + (process->crossover_time / WHEEL_SLOTS) % WHEEL_SLOTS;
+    }
+    else // beyond the wheel, parked in its last slot and hung again when that slot cascades
+    {
+        slot = WHEEL_SLOTS + ((current_time + WHEEL_SPAN - 1) / WHEEL_SLOTS) % WHEEL_SLOTS;
+    }
+
+    process->wheel_slot = slot;
+    process->wheel_prev = NULL;
+    process->wheel_next = aging_wheel[slot];
+    if (aging_wheel[slot] != NULL)
+    {
+        aging_wheel[slot]->wheel_prev = process;
+    }
+    aging_wheel[slot] = process;
+}
+
+void wheel_remove(Process* process)
+{
+    if (process->wheel_slot == -1)
+    {
+        return;
+    }
+
+    if (process->wheel_prev != NULL)
+    {
+        process->wheel_prev->wheel_next = process->wheel_next;
+    }
+    else
+    {
+        aging_wheel[process->wheel_slot] = process->wheel_next;
+    }
+    if (process->wheel_next != NULL)
+    {
+        process->wheel_next->wheel_prev = process->wheel_prev;
+    }
+    process->wheel_slot = -1;
+    process->wheel_next = NULL;
+    process->wheel_prev = NULL;
+}
+
+void advance_aging_wheel(int current_time) // Fire the crossovers due now, cascading level 1 when a level 0 round starts
+{
+    if (current_time % WHEEL_SLOTS == 0)
+    {
+        Process* p = aging_wheel[WHEEL_SLOTS + (current_time / WHEEL_SLOTS) % WHEEL_SLOTS];
+        while (p != NULL)
+        {
+            Process* next = p->wheel_next;
+            wheel_remove(p);
+            wheel_insert(p, current_time);
+            p = next;
+        }
+    }
+
+    Process* p = aging_wheel[current_time % WHEEL_SLOTS];
+    while (p != NULL)
+    {
+        Process* next = p->wheel_next;
+        if (p->crossover_time <= current_time)
+        {
+            wheel_remove(p);
+            preemption_check = true;
+        }
+        p = next;
+    }
+}
+
+Process* highest_waiting_process(int current_time) // First waiting process with the highest priority
+{
+    Process* p = ready_front->next;
+    Process* highest_priority_process = p;
+    while (p != NULL)
+    {
+        if (use_aging_wheel && fixed_priority)
+        {
+            p->priority_fixed = aged_priority_fixed(p, aged_time_in_waiting(p, current_time));
+        }
+        else if (use_aging_wheel)
+        {
+            p->priority = aged_priority(p, aged_time_in_waiting(p, current_time));
+        }
+        if (outranks(p, highest_priority_process, fixed_priority))
+        {
+            highest_priority_process = p;
+        }
+        p = p->next;
+    }
+    return highest_priority_process;
+}
+
+ENGINE_INLINE bool outranks(Process* a, Process* b, const bool fixed_point) // true if a has a strictly higher priority than b
+{
+    return fixed_point ? a->priority_fixed > b->priority_fixed : a->priority > b->priority;
+}
+
+double shown_priority(Process* process) // priority for the %.2f trace columns
+{
+    return fixed_priority ? (double)process->priority_fixed / PRIORITY_SCALE : process->priority;
+}
+
+// Decimal text to 1/PRIORITY_SCALE units. False unless the whole text is a plain decimal number of at most
+// MAX_PRIORITY with at most six decimals : anything else(an exponent, more digits) strtof would read differently.
+bool parse_fixed(const char* text, int64_t* value)
+{
+    int64_t integer = 0;
+    int64_t fraction = 0;
+    int64_t scale = PRIORITY_SCALE;
+    bool negative = *text == '-';
+    bool digits = false;
+
+    if (*text == '-' || *text == '+')
+    {
+        text++;
+    }
+    for (; *text >= '0' && *text <= '9'; text++)
+    {
+        integer = integer * 10 + (*text - '0');
+        digits = true;
+        if (integer > MAX_PRIORITY)
+        {
+            return false;
+        }
+    }
+    if (*text == '.')
+    {
+        for (text++; *text >= '0' && *text <= '9'; text++)
+        {
+            if (scale == 1)
+            {
+                return false;
+            }
+            scale /= 10;
+            fraction += (*text - '0') * scale;
+            digits = true;
+        }
+    }
+    if (!digits || *text != '\0' || (integer == MAX_PRIORITY && fraction > 0))
+    {
+        return false;
+    }
+    *value = (negative ? -1 : 1) * (integer * PRIORITY_SCALE + fraction);
+    return true;
+}
+
+void reset_devices(Process processes[]) // Empty every device queue before a new scheduling run
+{
+    for (int i = 0; i < MAX_DEVICES; i++)
+    {
+        devices[i].front = NULL;
+        devices[i].rear = NULL;
+        devices[i].busy_time = 0;
+    }
+
+    num_devices = 0; // devices 0 ~ highest device used by the workload
+    for (int i = 0; i < 10; i++)
+    {
+        for (int j = 0; j < processes[i].num_bursts - 1; j++)
+        {
+            if (processes[i].io_device[j] >= num_devices)
+            {
+                num_devices = processes[i].io_device[j] + 1;
+            }
+        }
+    }
+    io_busy_time = 0;
+    overlap_time = 0;
+}
+
+bool has_io_burst(Process* process) // true when the finished CPU burst is followed by an I/O burst
+{
+    return process->current_burst < process->num_bursts - 1;
+}
+
+void block_process(Process* process, int current_time) // Move a process to the device queue of its next I/O burst
+{
+    if (process == NULL)
+    {
+        fprintf(stderr, "Error: Process is NULL\n");
+        return;
+    }
+
+    Device* device = &devices[process->io_device[process->current_burst]];
+    LOG_EVENT(current_time, process->pid, EV_BLOCK);
+
+    process->io_remaining = process->io_burst[process->current_burst];
+    process->blocked_at = current_time;
+    process->ready_time = -1;
+    process->current_burst++;
+    process->remaining_time = process->cpu_burst[process->current_burst];
+    process->next = NULL;
+
+    if (device->front == NULL)
+    {
+        device->front = process;
+        device->rear = process;
+    }
+    else
+    {
+        device->rear->next = process;
+        device->rear = process;
+    }
+}
+
+void wake_io_processes(FILE* output, int current_time) // Move processes whose I/O burst is over back to the ready queue
+{
+    for (int i = 0; i < num_devices; i++)
+    {
+        Process* process = devices[i].front;
+        if (process == NULL || process->io_remaining != 0)
+        {
+            continue;
+        }
+
+        devices[i].front = process->next;
+        if (devices[i].front == NULL)
+        {
+            devices[i].rear = NULL;
+        }
+
+        process->io_time += current_time - process->blocked_at;
+        process->ready_time = current_time;
+        TRACE(output, "<time %d> [I/O done] process %d\n", current_time, process->pid);
+        LOG_EVENT(current_time, process->pid, EV_WAKE);
+        insert_process_ready(process);
+    }
+}
+
+void advance_devices(bool cpu_busy) // Serve one time unit of I/O at the head of each device queue
+{
+    bool io_busy = false;
+
+    for (int i = 0; i < num_devices; i++)
+    {
+        if (devices[i].front != NULL)
+        {
+            devices[i].front->io_remaining--;
+            devices[i].busy_time++;
+            io_busy = true;
+        }
+    }
+
+    if (io_busy)
+    {
+        io_busy_time++;
+        if (cpu_busy)
+        {
+            overlap_time++;
+        }
+    }
+}
+
+void print_io_summary(FILE* output, int total_time) // Device lines of the report, only for workloads with I/O
+{
+    for (int i = 0; i < num_devices; i++)
+    {
+        fprintf(output, "Device %d utilization : %.2f %%\n", i, ((float)devices[i].busy_time) / total_time * 100);
+    }
+    if (num_devices > 0)
+    {
+        fprintf(output, "CPU/I/O overlap : %.2f %%\n", ((float)overlap_time) / total_time * 100);
+    }
+}
+
+void reset_overhead() // Clear the context-switch state before a new scheduling run
+{
+    switch_pending = false;
+    switch_stall = 0;
+    cache_stall = 0;
+    switch_overhead = 0;
+    cache_overhead = 0;
+    cpu_handoffs = 0;
+    last_runner = NULL;
+}
+
+void context_switch(FILE* output) // Print a context switch and charge its cost at the end of the tick
+{
+    TRACE(output, "------------------------------ (Context-Switch)\n");
+    switch_pending = true;
+}
+
+bool in_switch_overhead() // true while the cpu still owes context-switch or cache-refill time
+{
+    return switch_stall > 0 || cache_stall > 0;
+}
+
+void spend_switch_overhead(FILE* output, int current_time) // One tick of overhead: nothing runs, but arrivals and I/O go on
+{
+    admit_arrivals(output, current_time);
+
+    if (switch_stall > 0)
+    {
+        TRACE(output, "<time %d> ---- context switch ----\n", current_time);
+        LOG_EVENT(current_time, 0, EV_SWITCH);
+        switch_stall--;
+        switch_overhead++;
+    }
+    else
+    {
+        TRACE(output, "<time %d> ---- cache refill ----\n", current_time);
+        LOG_EVENT(current_time, 0, EV_CACHE_REFILL);
+        cache_stall--;
+        cache_overhead++;
+    }
+    advance_devices(true);
+}
+
+void admit_arrivals(FILE* output, int current_time) // Move every process arriving now to the ready queue
+{
+    while (job_front != NULL && job_front->arrival_time == current_time)
+    {
+        Process* arrived_process = job_front;
+        TRACE(output, "<time %d> [new arrival] process %d\n", current_time, arrived_process->pid);
+        LOG_EVENT(current_time, arrived_process->pid, EV_ARRIVAL);
+        remove_from_job(arrived_process);
+        insert_process_ready(arrived_process);
+        arrived_process->priority = arrived_process->base_priority;
+        arrived_process->priority_fixed = arrived_process->base_priority_fixed;
+    }
+}
+
+ENGINE_INLINE void finish_tick(Process* runner, int current_time, const bool overhead_model) // Charge switch and cache overhead for the process that ran this tick, NULL if idle
+{
+    if (runner != NULL)
+    {
+        LOG_EVENT(current_time, runner->pid, EV_RUN);
+    }
+    else
+    {
+        LOG_EVENT(current_time, 0, EV_IDLE);
+    }
+
+    if (overhead_model && runner != NULL)
+    {
+        if (runner != last_runner)
+        {
+            cpu_handoffs++;
+            // other processes ran since this one last did; enough of them displace its working set
+            if (cache_penalty > 0 && runner->run_mark != -1 && cpu_handoffs - runner->run_mark - 1 >= cache_size)
+            {
+                cache_stall = cache_penalty;
+            }
+            last_runner = runner;
+        }
+        runner->run_mark = cpu_handoffs;
+
+        if (switch_pending)
+        {
+            switch_stall = switch_cost;
+        }
+    }
+    switch_pending = false;
+
+    advance_devices(runner != NULL);
+}
+
+void print_overhead_summary(FILE* output, int total_time, int idle_time) // Overhead lines of the report, only when a cost is set
+{
+    if (switch_cost == 0 && cache_penalty == 0)
+    {
+        return;
+    }
+    fprintf(output, "Context switch overhead : %d (switch %d + cache refill %d)\n", switch_overhead + cache_overhead, switch_overhead, cache_overhead);
+    fprintf(output, "Effective cpu usage : %.2f %%\n", ((float)(total_time - idle_time - switch_overhead - cache_overhead)) / total_time * 100);
+}
+
+void insert_process_job(Process* process)
+{
+    if (process == NULL)
+    {
+        fprintf(stderr, "Error: Process is NULL\n");
+        return;
+    }
+
+    if (job_front == NULL)
+    {
+        job_front = process;
+        job_rear = process;
+    }
+    else
+    {
+        job_rear->next = process;
+        job_rear = process;
+    }
+}
+
+void insert_process_ready(Process* process)
+{
+    if (process == NULL)
+    {
+        fprintf(stderr, "Error: Process is NULL\n");
+        return;
+    }
+
+    process->next = NULL;
+    ready_insertions++;
+    preemption_check = true;
+
+    if (ready_front == NULL)
+    {
+        ready_front = process;
+        ready_rear = process;
+    }
+    else
+    {
+        ready_rear->next = process;
+        ready_rear = process;
+    }
+}
+
+void remove_from_job(Process* process)
+{
+    if (process == NULL)
+    {
+        fprintf(stderr, "Error: Process is NULL\n");
+        return;
+    }
+
+    if (job_front == process)
+    {
+        job_front = job_front->next;
+
+        if (job_front == NULL)
+        {
+            job_rear = NULL;
+        }
+    }
+}
+
+void remove_from_ready(Process* process)
+{
+    if (process == NULL)
+    {
+        fprintf(stderr, "Error: Process is NULL\n");
+        return;
+    }
+
+    if (ready_front == process)
+    {
+        ready_front = ready_front->next;
+
+        if (ready_front == NULL)
+        {
+            ready_rear = NULL;
+        }
+    }
+    else
+    {
+        Process* temp = ready_front;
+        while (temp->next != NULL && temp->next != process)
+        {
+            temp = temp->next;
+        }
+        if (temp->next != NULL)
+        {
+            temp->next = temp->next->next;
+            if (temp->next == NULL)
+            {
+                ready_rear = temp;
+            }
+        }
+    }
+}
+
+
+int run_daemon(char* socket_path, int num_workers) // Serve simulation requests on a local Unix socket
+{
+    struct sockaddr_un address;
+
+    if (num_workers < 1 || strlen(socket_path) >= sizeof(address.sun_path)) // defensive coding
+    {
+        fprintf(stderr, "Error; worker threads is positive integer, socket path is too long\n");
+        return 1;
+    }
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0)
+    {
+        perror("Error Opening Socket");
+        return 1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+    unlink(socket_path); // stale socket of a previous daemon
+
+    if (bind(server, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(server, 64) < 0)
+    {
+        perror("Error Binding Socket");
+        close(server);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN); // a client hanging up must not kill the daemon
+
+    for (int i = 0; i < num_workers; i++)
+    {
+        pthread_t worker;
+        if (pthread_create(&worker, NULL, daemon_worker, NULL) != 0)
+        {
+            perror("Error Creating Worker");
+            close(server);
+            return 1;
+        }
+        pthread_detach(worker);
+    }
+
+    while (true) // accept loop, workers pick the connections up in FIFO order
+    {
+        int client = accept(server, NULL, NULL);
+        if (client < 0)
+        {
+            continue;
+        }
+        struct timeval send_timeout = { REQUEST_TIMEOUT / 1000, REQUEST_TIMEOUT % 1000 * 1000 }; // a client that never reads cannot hold a worker
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+
+        pthread_mutex_lock(&client_lock);
+        while (client_count == 64)
+        {
+            pthread_cond_wait(&client_space, &client_lock);
+        }
+        client_queue[(client_head + client_count) % 64] = client;
+        client_count++;
+        pthread_cond_signal(&client_ready);
+        pthread_mutex_unlock(&client_lock);
+    }
+    return 0;
+}
+
+void* daemon_worker(void* arg)
+{
+    (void)arg;
+
+    while (true)
+    {
+        pthread_mutex_lock(&client_lock);
+        while (client_count == 0)
+        {
+            pthread_cond_wait(&client_ready, &client_lock);
+        }
+        int client = client_queue[client_head];
+        client_head = (client_head + 1) % 64;
+        client_count--;
+        pthread_cond_signal(&client_space);
+        pthread_mutex_unlock(&client_lock);
+
+        serve_client(client);
+    }
+    return NULL;
+}
+
+// Request : "<FCFS|RR|PRIO|EDF|RM|GROUP|ALL> quantum alpha [switch_cost cache_penalty cache_size [fixed_point]]" on the first line,
+// then the workload in the input file format, ended by a line "END" or by closing the write side, all within
+// REQUEST_TIMEOUT ms. Response : the summary of each requested policy, flushed as soon as that policy is done.
+void serve_client(int client)
+{
+    char received[MAX_WORKLOAD_SIZE + 1024]; // request line, workload and END
+    long received_length = receive_request(client, received, sizeof(received));
+    FILE* request = received_length >= 0 ? fmemopen(received, received_length, "r") : NULL;
+    FILE* report = fdopen(client, "w");
+    if (request == NULL || report == NULL)
+    {
+        if (report != NULL && received_length == -1)
+        {
+            fprintf(report, "Error; request timed out\n");
+        }
+        else if (report != NULL && received_length == -2)
+        {
+            fprintf(report, "Error; workload is empty or larger than %d bytes\n", MAX_WORKLOAD_SIZE);
+            fflush(report);
+            shutdown(client, SHUT_WR);
+
+            // closing with unread input resets the connection before the client reads the reply, so drain a bounded amount
+            char scratch[512];
+            struct pollfd pending = { client, POLLIN, 0 };
+            for (int i = 0; i < MAX_WORKLOAD_SIZE / 512 && poll(&pending, 1, REQUEST_TIMEOUT) > 0 && read(client, scratch, sizeof(scratch)) > 0; i++)
+            {
+            }
+        }
+        if (request != NULL)
+        {
+            fclose(request);
+        }
+        if (report != NULL)
+        {
+            fclose(report);
+        }
+        else
+        {
+            close(client);
+        }
+        return;
+    }
+
+    char line[512];
+    char policy[8] = "";
+    int request_quantum = 0;
+    char request_alpha[32] = "";
+    int64_t request_alpha_fixed = 0;
+    int request_switch_cost = 0;
+    int request_cache_penalty = 0;
+    int request_cache_size = 1;
+    int request_fixed_point = 0;
+
+    if (fgets(line, sizeof(line), request) == NULL ||
+        sscanf(line, "%7s %d %31s %d %d %d %d", policy, &request_quantum, request_alpha,
+            &request_switch_cost, &request_cache_penalty, &request_cache_size, &request_fixed_point) < 3)
+    {
+        fprintf(report, "Error; request line is [policy] [quantum] [alpha] [switch_cost cache_penalty cache_size [fixed_point]]\n");
+        fclose(request);
+        fclose(report);
+        return;
+    }
+
+    char text[MAX_WORKLOAD_SIZE];
+    size_t length = 0;
+    while (fgets(line, sizeof(line), request) != NULL && strcmp(line, "END\n") != 0 && strcmp(line, "END") != 0)
+    {
+        size_t line_length = strlen(line);
+        if (length + line_length > sizeof(text))
+        {
+            length = sizeof(text) + 1;
+            break;
+        }
+        memcpy(text + length, line, line_length);
+        length += line_length;
+    }
+
+    bool fcfs = strcmp(policy, "FCFS") == 0 || strcmp(policy, "ALL") == 0;
+    bool rr = strcmp(policy, "RR") == 0 || strcmp(policy, "ALL") == 0;
+    bool prio = strcmp(policy, "PRIO") == 0 || strcmp(policy, "ALL") == 0;
+    bool edf = strcmp(policy, "EDF") == 0 || strcmp(policy, "ALL") == 0;
+    bool rm = strcmp(policy, "RM") == 0 || strcmp(policy, "ALL") == 0;
+    bool group = strcmp(policy, "GROUP") == 0 || strcmp(policy, "ALL") == 0;
+    Process processes[10];
+
+    if (!fcfs && !rr && !prio && !edf && !rm && !group)
+    {
+        fprintf(report, "Error; policy is FCFS, RR, PRIO, EDF, RM, GROUP or ALL\n");
+    }
+    else if (length > sizeof(text) || length == 0)
+    {
+        fprintf(report, "Error; workload is empty or larger than %d bytes\n", MAX_WORKLOAD_SIZE);
+    }
+    else if (((rr || group) && request_quantum < 1) || (prio && (!parse_fixed(request_alpha, &request_alpha_fixed) ||
+        request_alpha_fixed < 0 || request_alpha_fixed > PRIORITY_SCALE)) ||
+        request_switch_cost < 0 || request_cache_penalty < 0 || request_cache_size < 1)
+    {
+        fprintf(report, "Error; Quantum is positive integer, alpha range[0~1], overheads are non-negative\n");
+    }
+    else if (!lookup_workload(text, length, processes, report)) // the reason is already on the report
+    {
+        fprintf(report, "Error; malformed workload\n");
+    }
+    else
+    {
+        Process run[10];
+
+        switch_cost = request_switch_cost;
+        cache_penalty = request_cache_penalty;
+        cache_size = request_cache_size;
+        fixed_priority = request_fixed_point != 0;
+
+        if (fcfs)
+        {
+            memcpy(run, processes, sizeof(run));
+            simulate_fcfs(run, NULL, report);
+            fflush(report);
+        }
+        if (rr)
+        {
+            memcpy(run, processes, sizeof(run));
+            simulate_rr(run, request_quantum, NULL, report);
+            fflush(report);
+        }
+        if (prio)
+        {
+            memcpy(run, processes, sizeof(run));
+            simulate_priority(run, strtof(request_alpha, NULL), request_alpha_fixed, NULL, report);
+            fflush(report);
+        }
+        if (strcmp(policy, "ALL") == 0 && !has_deadlines(processes)) // as in simulate(), no real-time sections without deadlines
+        {
+            edf = false;
+            rm = false;
+        }
+        if (edf)
+        {
+            memcpy(run, processes, sizeof(run));
+            simulate_edf(run, NULL, report);
+            fflush(report);
+        }
+        if (rm)
+        {
+            memcpy(run, processes, sizeof(run));
+            simulate_rm(run, NULL, report);
+            fflush(report);
+        }
+        if (strcmp(policy, "ALL") == 0 && !has_groups(processes)) // nor fair-share sections without groups
+        {
+            group = false;
+        }
+        for (int inside = GROUP_FCFS; group && inside <= GROUP_PRIO; inside++)
+        {
+            memcpy(run, processes, sizeof(run));
+            simulate_group(run, inside, request_quantum, NULL, report);
+            fflush(report);
+        }
+    }
+
+    fclose(request);
+    fclose(report);
+}
+
+// Read a whole request into buffer, NUL-terminated : up to a line "END" or the client closing its write side. The
+// deadline covers the whole request, so neither a silent client nor one sending a byte at a time holds a worker.
+// Returns the length, -1 on timeout or a read error, -2 if the request does not fit.
+long receive_request(int client, char* buffer, size_t size)
+{
+    struct timespec start, now;
+    size_t length = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    buffer[0] = '\0';
+    while (strstr(buffer, "\nEND\n") == NULL)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long elapsed = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+        struct pollfd pending = { client, POLLIN, 0 };
+        if (elapsed >= REQUEST_TIMEOUT || poll(&pending, 1, REQUEST_TIMEOUT - elapsed) <= 0)
+        {
+            return -1;
+        }
+        if (length == size - 1)
+        {
+            return -2;
+        }
+
+        ssize_t n = read(client, buffer + length, size - 1 - length);
+        if (n < 0)
+        {
+            return -1;
+        }
+        if (n == 0) // write side closed
+        {
+            break;
+        }
+        length += n;
+        buffer[length] = '\0';
+    }
+    return length;
+}
+
+uint64_t hash_workload(const char* text, size_t length) // FNV-1a
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)text[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Copy the parsed, sorted workload for this text into processes[], parsing it only on a cache miss.
+// The cache is direct-mapped: a miss replaces whatever workload held the slot.
+bool lookup_workload(const char* text, size_t length, Process processes[], FILE* errors) // parse errors go to errors
+{
+    uint64_t hash = hash_workload(text, length);
+    WorkloadEntry* entry = &workload_cache[hash % WORKLOAD_CACHE_SIZE];
+
+    pthread_rwlock_rdlock(&workload_cache_lock);
+    if (entry->text != NULL && entry->hash == hash && entry->length == length && memcmp(entry->text, text, length) == 0)
+    {
+        memcpy(processes, entry->processes, sizeof(entry->processes));
+        pthread_rwlock_unlock(&workload_cache_lock);
+        return true;
+    }
+    pthread_rwlock_unlock(&workload_cache_lock);
+
+    FILE* file = fmemopen((void*)text, length, "r");
+    if (file == NULL)
+    {
+        return false;
+    }
+    init_process(processes, 10);
+    bool parsed = parse_process(processes, file, errors);
+    fclose(file);
+    if (!parsed)
+    {
+        return false;
+    }
+    sort_process(processes);
+
+    char* copy = malloc(length);
+    if (copy == NULL)
+    {
+        return true; // still served, just not cached
+    }
+    memcpy(copy, text, length);
+
+    pthread_rwlock_wrlock(&workload_cache_lock);
+    free(entry->text);
+    entry->hash = hash;
+    entry->text = copy;
+    entry->length = length;
+    memcpy(entry->processes, processes, sizeof(entry->processes));
+    pthread_rwlock_unlock(&workload_cache_lock);
+    return true;
+}
+
+void log_event(int time, int pid, int type) // Append a record to the replay log of the run in progress
+{
+    Event event = { time, pid, type };
+    append_event(event_log, event);
+}
+
+void append_event(EventLog* log, Event event)
+{
+    if (log->count == log->capacity)
+    {
+        size_t capacity = log->capacity == 0 ? 1024 : log->capacity * 2;
+        Event* events = realloc(log->events, capacity * sizeof(Event));
+        if (events == NULL) // defensive coding
+        {
+            perror("Error Growing Event Log");
+            exit(1);
+        }
+        log->events = events;
+        log->capacity = capacity;
+    }
+    log->events[log->count++] = event;
+}
+
+bool write_event_log(EventLog* log, char* filename)
+{
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    bool written = fwrite(EVENT_LOG_MAGIC, 1, 8, file) == 8 &&
+        (log->count == 0 || fwrite(log->events, sizeof(Event), log->count, file) == log->count);
+    return fclose(file) == 0 && written;
+}
+
+bool read_event_log(EventLog* log, char* filename)
+{
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    char magic[8];
+    Event event;
+    if (fread(magic, 1, 8, file) != 8 || memcmp(magic, EVENT_LOG_MAGIC, 8) != 0)
+    {
+        fclose(file);
+        return false;
+    }
+    while (fread(&event, sizeof(Event), 1, file) == 1)
+    {
+        append_event(log, event);
+    }
+    fclose(file);
+    return true;
+}
+
+long first_divergence(EventLog* a, EventLog* b) // Index of the first record that differs, -1 if the logs are identical
+{
+    size_t i = 0;
+    while (i < a->count && i < b->count && memcmp(&a->events[i], &b->events[i], sizeof(Event)) == 0)
+    {
+        i++;
+    }
+    if (i == a->count && i == b->count)
+    {
+        return -1;
+    }
+    return (long)i;
+}
+
+void print_event(FILE* output, const char* label, EventLog* log, long index)
+{
+    if ((size_t)index >= log->count)
+    {
+        fprintf(output, "  %s : end of log\n", label);
+        return;
+    }
+
+    Event* event = &log->events[index];
+    if (event->type < 0 || event->type >= EV_TYPES)
+    {
+        fprintf(output, "  %s : unknown event %d\n", label, event->type);
+    }
+    else if (event->type == EV_SECTION)
+    {
+        fprintf(output, "  %s : ---- %s ----\n", label, event->pid >= 0 && event->pid < 8 ? section_names[event->pid] : "?");
+    }
+    else if (event->type == EV_RESPONSE)
+    {
+        fprintf(output, "  %s : process %d response time %d\n", label, event->pid, event->time);
+    }
+    else if (event->pid == 0) // idle and overhead ticks belong to no process
+    {
+        fprintf(output, "  %s : <time %d> %s\n", label, event->time, event_names[event->type]);
+    }
+    else
+    {
+        fprintf(output, "  %s : <time %d> process %d %s\n", label, event->time, event->pid, event_names[event->type]);
+    }
+}
+
+void print_divergence(FILE* output, const char* label_a, EventLog* a, const char* label_b, EventLog* b, long index)
+{
+    const char* section = "?";
+    for (long i = index - 1; i >= 0; i--) // both logs agree up to index
+    {
+        if (a->events[i].type == EV_SECTION && a->events[i].pid >= 0 && a->events[i].pid < 8)
+        {
+            section = section_names[a->events[i].pid];
+            break;
+        }
+    }
+    fprintf(output, "First divergence at event %ld(%s section)\n", index, section);
+    print_event(output, label_a, a, index);
+    print_event(output, label_b, b, index);
+}
+
+int diff_event_logs(char* filename_a, char* filename_b) // 0 if the logs are identical, 1 if they differ, 2 on errors as diff(1)
+{
+    EventLog a = { NULL, 0, 0 };
+    EventLog b = { NULL, 0, 0 };
+
+    char* unreadable = !read_event_log(&a, filename_a) ? filename_a : !read_event_log(&b, filename_b) ? filename_b : NULL;
+    if (unreadable != NULL) // defensive coding
+    {
+        fprintf(stderr, "Error; %s is not a readable event log\n", unreadable);
+        exit(2);
+    }
+
+    long index = first_divergence(&a, &b);
+    if (index == -1)
+    {
+        printf("Event logs are identical(%zu events)\n", a.count);
+    }
+    else
+    {
+        print_divergence(stdout, filename_a, &a, filename_b, &b, index);
+    }
+    free(a.events);
+    free(b.events);
+    return index == -1 ? 0 : 1;
+}
+
+// Random workload in the input format, with I/O, deadlines and groups. One in eight has all bursts 1 and all
+// arrivals at 0, and one in eight is malformed on purpose(*well_formed false) : short, 11 processes, or a zero burst.
+size_t random_workload(char* text, size_t size, unsigned* seed, bool* well_formed)
+{
+    const int periods[5] = { 4, 6, 8, 12, 24 }; // keeps the hyperperiod at 24
+    int group_weights[4] = { 0, 0, 0, 0 };
+    size_t length = 0;
+    int arrival = 0;
+    bool edge = rand_r(seed) % 8 == 0;
+    int flaw = rand_r(seed) % 8 == 0 ? 1 + rand_r(seed) % 4 : 0; // 1 : short, 2 : 11 processes, 3 : zero first burst, 4 : zero later burst
+    int num_processes = flaw == 1 ? rand_r(seed) % 10 : flaw == 2 ? 11 : 10;
+    int flawed_pid = 1 + rand_r(seed) % 10;
+
+    *well_formed = flaw == 0;
+    for (int pid = 1; pid <= num_processes; pid++)
+    {
+        bool flawed = pid == flawed_pid && flaw >= 3;
+        arrival += edge || rand_r(seed) % 3 == 0 ? 0 : rand_r(seed) % 5;
+        length += snprintf(text + length, size - length, "%d %d %d %d", pid, 1 + rand_r(seed) % 10, arrival,
+            flawed && flaw == 3 ? 0 : edge ? 1 : 1 + rand_r(seed) % 8);
+
+        int io_bursts = flawed && flaw == 4 ? 1 : rand_r(seed) % 4 == 0 ? 1 + rand_r(seed) % 2 : 0;
+        for (int i = 0; i < io_bursts; i++)
+        {
+            if (flawed && flaw == 4)
+            {
+                length += snprintf(text + length, size - length, rand_r(seed) % 2 == 0 ? " 0 0 1" : " 0 1 0");
+            }
+            else
+            {
+                length += snprintf(text + length, size - length, " %d %d %d", rand_r(seed) % 3, edge ? 1 : 1 + rand_r(seed) % 5, edge ? 1 : 1 + rand_r(seed) % 5);
+            }
+        }
+        if (rand_r(seed) % 4 == 0)
+        {
+            int period = periods[rand_r(seed) % 5];
+            length += snprintf(text + length, size - length, " @ %d %d", period, 1 + rand_r(seed) % period);
+        }
+        if (rand_r(seed) % 3 == 0)
+        {
+            int group = rand_r(seed) % 4;
+            if (group_weights[group] == 0) // the weight of a group is given by its first member only
+            {
+                group_weights[group] = 1 + rand_r(seed) % 4;
+                length += snprintf(text + length, size - length, " # %d %d", group, group_weights[group]);
+            }
+            else
+            {
+                length += snprintf(text + length, size - length, " # %d", group);
+            }
+        }
+        length += snprintf(text + length, size - length, "\n");
+    }
+    if (rand_r(seed) % 8 == 0) // a trailing blank line is not a process
+    {
+        length += snprintf(text + length, size - length, "\n");
+    }
+    return length;
+}
+
+void run_engine(Process processes[], const Engine* engine, int quantum, float alpha, int64_t alpha_fixed, EventLog* log, FILE* sink) // Every section of a workload on one engine
+{
+    Process run[10];
+    FILE* output = engine->traced ? sink : NULL;
+
+    aging_wheel_mode = engine->aging_wheel;
+    force_overhead_model = engine->overhead_model;
+    log->count = 0;
+    event_log = log;
+
+    memcpy(run, processes, sizeof(run));
+    simulate_fcfs(run, output, sink);
+    memcpy(run, processes, sizeof(run));
+    simulate_rr(run, quantum, output, sink);
+    memcpy(run, processes, sizeof(run));
+    simulate_priority(run, alpha, alpha_fixed, output, sink);
+    if (has_deadlines(processes))
+    {
+        memcpy(run, processes, sizeof(run));
+        simulate_edf(run, output, sink);
+        memcpy(run, processes, sizeof(run));
+        simulate_rm(run, output, sink);
+    }
+    if (has_groups(processes))
+    {
+        for (int policy = GROUP_FCFS; policy <= GROUP_PRIO; policy++)
+        {
+            memcpy(run, processes, sizeof(run));
+            simulate_group(run, policy, quantum, output, sink);
+        }
+    }
+
+    event_log = NULL;
+    aging_wheel_mode = -1;
+    force_overhead_model = false;
+}
+
+// Differential check: random workloads and settings go through every engine of fuzz_engines[], and each must log
+// exactly the events of the reference. Workload i is generated from seed + i, so a divergence can be replayed alone.
+int run_fuzz(int iterations, unsigned seed)
+{
+    const int num_engines = sizeof(fuzz_engines) / sizeof(fuzz_engines[0]);
+    const char* alphas[6] = { "0", "0.1", "0.25", "0.3", "0.5", "1" }; // parsed as the command line does
+    EventLog logs[sizeof(fuzz_engines) / sizeof(fuzz_engines[0])];
+    char text[2048];
+    int divergences = 0;
+    int rejected = 0; // malformed workloads, each must fail to parse
+
+    FILE* sink = fopen("/dev/null", "w"); // traces and reports are not kept
+    if (sink == NULL)
+    {
+        perror("Error Opening /dev/null");
+        exit(1);
+    }
+    for (int e = 0; e < num_engines; e++)
+    {
+        logs[e] = (EventLog){ NULL, 0, 0 };
+    }
+
+    for (int i = 0; i < iterations && divergences == 0; i++)
+    {
+        unsigned state = seed + i;
+        bool well_formed;
+        size_t length = random_workload(text, sizeof(text), &state, &well_formed);
+        int run_quantum = 1 + rand_r(&state) % 4;
+        const char* alpha_text = alphas[rand_r(&state) % 6];
+        float run_alpha = strtof(alpha_text, NULL);
+        int64_t run_alpha_fixed = 0;
+        parse_fixed(alpha_text, &run_alpha_fixed);
+        switch_cost = rand_r(&state) % 2 == 0 ? 0 : rand_r(&state) % 3;
+        cache_penalty = rand_r(&state) % 2 == 0 ? 0 : rand_r(&state) % 4;
+        cache_size = 1 + rand_r(&state) % 3;
+
+        Process processes[10];
+        FILE* file = fmemopen(text, length, "r");
+        init_process(processes, 10);
+        if (file == NULL) // defensive coding
+        {
+            perror("Error Opening Fuzz Workload");
+            exit(1);
+        }
+        bool parsed = parse_process(processes, file, NULL); // malformed on purpose, no message
+        fclose(file);
+        if (parsed != well_formed)
+        {
+            printf("Parser %s workload %u :\n%s", parsed ? "accepts malformed" : "rejects well-formed", seed + i, text);
+            divergences++;
+            break;
+        }
+        if (!parsed)
+        {
+            rejected++;
+            continue;
+        }
+        sort_process(processes);
+
+        for (int e = 0; e < 2 * num_engines && divergences == 0; e++) // float priorities, then fixed-point ones
+        {
+            const Engine* engine = &fuzz_engines[e % num_engines];
+            fixed_priority = e >= num_engines;
+            run_engine(processes, engine, run_quantum, run_alpha, run_alpha_fixed, &logs[e % num_engines], sink);
+            long index = e % num_engines == 0 ? -1 : first_divergence(&logs[0], &logs[e % num_engines]);
+            if (index != -1)
+            {
+                printf("Engine '%s' diverges from '%s' on workload %u(quantum %d, alpha %.2f, -s %d -c %d -k %d -f %d) :\n%s",
+                    engine->name, fuzz_engines[0].name, seed + i, run_quantum, run_alpha, switch_cost, cache_penalty, cache_size, fixed_priority, text);
+                print_divergence(stdout, fuzz_engines[0].name, &logs[0], engine->name, &logs[e % num_engines], index);
+                divergences++;
+            }
+        }
+        fixed_priority = false;
+    }
+
+    if (divergences == 0)
+    {
+        printf("Fuzz : %d workloads(%d malformed, all rejected), %d engines agree with the reference, with float and fixed-point priorities\n",
+            iterations, rejected, num_engines - 1);
+    }
+    for (int e = 0; e < num_engines; e++)
+    {
+        free(logs[e].events);
     }
+    fclose(sink);
+    return divergences == 0 ? 0 : 1;
 }